@@ -1,31 +1,159 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
 #include <cstdlib>
 #include <iostream>
+#include <string>
 
+#include "mygl/alloctrack.h"
 #include "mygl/camera.h"
+#include "mygl/capture.h"
+#include "mygl/culling.h"
+#include "mygl/drawlist.h"
+#include "mygl/dynamicresolution.h"
+#include "mygl/framearena.h"
+#include "mygl/framebuffer.h"
+#include "mygl/framepacing.h"
 #include "mygl/geometry.h"
+#include "mygl/inputlog.h"
+#include "mygl/lod.h"
 #include "mygl/mesh.h"
+#include "mygl/meshbuffer.h"
+#include "mygl/meshpack.h"
+#include "mygl/occlusion.h"
+#include "mygl/profiler.h"
+#include "mygl/scenegraph.h"
 #include "mygl/shader.h"
+#include "mygl/shadervariants.h"
+#include "mygl/spatialhash.h"
+#include "mygl/threadpool.h"
+#include "mygl/views.h"
 
+#include "fleet.h"
 #include "ground.h"
 #include "pickup.h"
 
+/* struct holding all command line options */
+struct {
+    unsigned int numParkedPickups = 0;  // --pickups N
+    std::string shaderCacheDir;         // --shader-cache DIR
+    std::string recordPath;             // --record PATH (.y4m, .rgba/.raw or prefix of numbered PNGs)
+    unsigned int recordFps = 60;        // --record-fps N
+    bool headless = false;              // --headless (offscreen framebuffer, no vsync, hidden or no window)
+    int width = 1280;                   // --size WxH
+    int height = 720;
+    unsigned int maxFrames = 0;         // --frames N (0 runs until the window is closed)
+    float frameDt = 1.0f / 60.0f;       // --frame-dt SECONDS (simulated time per frame when headless)
+    std::string tracePath;              // --trace PATH (Chrome trace JSON, not available in Release builds)
+    bool vsync = true;                  // --vsync on|off
+    double targetFps = 0.0;             // --fps N (sleep + spin limiter, 0 = unlimited)
+    double statsInterval = 0.0;         // --stats-interval SECONDS (periodic frame time percentiles, 0 = off)
+    double simRate = 60.0;              // --sim-rate HZ (fixed simulation steps per second)
+    unsigned int simMaxSteps = 5;       // --sim-max-steps N (catch-up steps per frame at most)
+    std::string inputRecordPath;        // --record-input PATH (binary input log, written on exit)
+    std::string replayPath;             // --replay PATH (feeds a recorded input log back at a fixed timestep)
+    bool noRender = false;              // --no-render (replay the simulation only, nothing is drawn)
+    double frameBudgetMs = 0.0;         // --frame-budget MS (GPU frame time the render resolution adapts to, 0 = off)
+    float minScale = 0.25f;             // --min-scale S (lowest render resolution per axis with --frame-budget)
+    std::string meshPackPath = "meshes.pack"; // --meshes PATH (baked by mesh_baker, built-in geometry if missing)
+    float lodTolerance = 0.5f;          // --lod-tolerance PX (largest LOD error on screen, 0 = always the finest level)
+    bool driveParked = false;           // --drive-parked (the parked pickups drive in circles, simulated as a fleet)
+    unsigned int fleetBenchmark = 0;    // --fleet-benchmark N (times the fleet step for N vehicles and exits)
+    unsigned int broadphaseBenchmark = 0; // --broadphase-benchmark N (times the spatial hash for N moving vehicles and exits)
+    unsigned int viewLayout = 0;        // --views single|minimap|split (see eViewLayout, cycle with V)
+    unsigned int frameArenaKiB = 256;   // --frame-arena KiB (initial size of each per-thread frame arena, grows if needed)
+    unsigned int allocWarmup = 120;     // --alloc-warmup N (frames before allocation call sites are recorded, ALLOC_TRACKING builds)
+} sOptions;
+
 /* struct holding all necessary state variables for scene */
 struct {
     Camera camera;
     bool cameraFollowPickup;
     float zoomSpeedMultiplier;
 
+    MeshBuffer meshBuffer;
+    SceneGraph sceneGraph;
     Ground ground;
-    Pickup pickup;
+    std::vector<Pickup> pickups; // pickups[0] is driven by the user, the others are parked
+    std::vector<MeshLod> lods;   // levels of detail picked per instance from the size on screen (wheels)
+
+    /* --drive-parked: simulation state of the parked pickups, vehicle i is pickups[i + 1] */
+    bool fleetDriving;
+    Fleet fleet;
+    FleetParams fleetParams;
+
+    /* broadphase over the vehicle positions, rebuilt after every simulation step */
+    SpatialHash broadphase;
+    std::vector<Vector3D> vehiclePositions;
+    SpatialHashPairs vehicleContacts;   // vehicles whose bounding spheres overlap
+    float vehicleRadius;
 
     // Fahr-Parameter (Task 2)
     float moveSpeed;
     float maxSteeringAngleRad;
     float turningAnglePerMeterDeg;
 
-    ShaderProgram shaderColor;
+    /* fixed timestep simulation, rendering interpolates between the previous and the current pickup state */
+    double simStep;
+    unsigned int simMaxSteps;
+    double simAccumulator;
+    PickupState pickupPrevious;
+    unsigned long long simSteps;
+    double simDroppedTime;
+
+    /* color shader variants, selected by feature flags (see eShaderFeature) instead of runtime uniforms */
+    ShaderVariants shaderColor;
+    bool checkerboard;
+
+    /* frame preparation: each worker fills its own draw list, the GL thread replays the merged list */
+    ThreadPool workers;
+    std::vector<DrawList> workerLists;
+
+    /* transient data of the frame (draw items, culling scratch), one sub-arena per worker and one for the main thread */
+    FrameArena frameArena;
+    DrawList drawList;
+
+    /* all views of the frame share one draw list, culling tags each command with the views that see it */
+    unsigned int viewLayout;
+    ViewSet views;
+    std::vector<Frustum> viewFrustums;
+
+    /* optional occlusion culling of vehicles with hardware queries (toggle with O) */
+    bool occlusionEnabled;
+    OcclusionQueries occlusion;
+    Mesh occlusionBox;
+
+    /* heap allocations of the last frame and of all frames after the warm-up (ALLOC_TRACKING builds only) */
+    AllocFrameStats allocFrame;
+    AllocFrameStats allocSteady;
+    unsigned long long allocSteadyFrames;
+    unsigned long long allocFramesAllocating;
+
+    /* rolling frame/update time statistics of the main loop (printed with I) */
+    FrameHistogram frameTimes;
+    FrameHistogram updateTimes;
+
+    /* screenshots (P) and recordings (R) are read back into pixel buffers and encoded on background threads */
+    Capture capture;
+    bool screenshotRequested;
+
+    /* dynamic resolution (--frame-budget): the scene is rendered at a scaled size and upscaled to the output */
+    bool resolutionScaling;
+    DynamicResolution resolution;
+
+    /* input changes are recorded per simulation step (--record-input) or fed back from a log (--replay) */
+    InputLog inputLog;
+    bool inputRecording;
+    bool inputReplaying;
 } sScene;
 
+/* views rendered per frame: the main camera alone, with a top-down minimap, or split screen with a follow camera */
+enum eViewLayout : unsigned int { ViewLayoutSingle = 0, ViewLayoutMinimap = 1, ViewLayoutSplit = 2, ViewLayoutCount = 3 };
+
+/* feature flags of the color shader, bit order matches the define names passed to shaderVariantsLoad */
+enum eShaderFeature : unsigned int { ShaderFeatureCheckerboard = 1u << 0 };
+
 /* calculate how much the car approximately turns per meter travelled for a given turning angle */
 float calculateTurningAnglePerMeter(float wheelBase, float turningAngle, float width) {
     float turningRadius = wheelBase / tan(turningAngle);
@@ -40,6 +168,73 @@ struct {
     bool buttonPressed[4] = {false, false, false, false}; // W,S,A,D
 } sInput;
 
+/* adds an input change to the log, it takes effect before the next simulation step in the replay as well */
+void inputRecord(eInputEvent type, float a, float b = 0.0f, float c = 0.0f) {
+    if (sScene.inputRecording) {
+        inputLogAdd(sScene.inputLog, static_cast<std::uint32_t>(sScene.simSteps), type, a, b, c);
+    }
+}
+
+/* car control buttons as bit mask (bit i = sInput.buttonPressed[i]) */
+unsigned int inputButtonMask() {
+    unsigned int mask = 0;
+    for (unsigned int i = 0; i < 4; i++) {
+        mask |= sInput.buttonPressed[i] ? 1u << i : 0u;
+    }
+    return mask;
+}
+
+/* camera mode 1 orbits around the origin, camera mode 2 follows the pickup */
+void inputCameraMode(int mode) {
+    sScene.cameraFollowPickup = (mode == 2);
+    if (mode == 1) {
+        sScene.camera.lookAt = {0.0f, 0.0f, 0.0f};
+    }
+    inputRecord(InputEventCameraMode, static_cast<float>(mode));
+}
+
+void inputCameraOrbit(const Vector2D &mouseDiff, float zoom) {
+    cameraUpdateOrbit(sScene.camera, mouseDiff, zoom);
+    inputRecord(InputEventOrbit, mouseDiff.x, mouseDiff.y, zoom);
+}
+
+/* applies a recorded event during replay */
+void inputApply(const InputEvent &event) {
+    switch (event.type) {
+    case InputEventButtons:
+        for (unsigned int i = 0; i < 4; i++) {
+            sInput.buttonPressed[i] = (static_cast<unsigned int>(event.values[0]) >> i) & 1u;
+        }
+        break;
+    case InputEventOrbit:
+        inputCameraOrbit(Vector2D(event.values[0], event.values[1]), event.values[2]);
+        break;
+    case InputEventCameraMode:
+        inputCameraMode(static_cast<int>(event.values[0]));
+        break;
+    }
+}
+
+/* hash of the simulation state (step count, all pickups and the fleet), equal inputs give equal hashes */
+std::uint64_t sceneStateHash() {
+    std::uint64_t hash = inputLogHash(&sScene.simSteps, sizeof(sScene.simSteps));
+    for (const auto &pickup : sScene.pickups) {
+        PickupState state = pickupGetState(pickup);
+        for (int j = 0; j < 4; j++) {
+            const Vector4D &column = state.vehicleTransform[j];
+            float values[4] = {column.x, column.y, column.z, column.w};
+            hash = inputLogHash(values, sizeof(values), hash);
+        }
+        hash = inputLogHash(&state.wheelRotationAngle, sizeof(float), hash);
+        hash = inputLogHash(&state.wheelSteeringAngle, sizeof(float), hash);
+    }
+    const Fleet &fleet = sScene.fleet;
+    for (const auto *values : {&fleet.posX, &fleet.posY, &fleet.posZ, &fleet.heading, &fleet.steering, &fleet.wheelAngle}) {
+        hash = inputLogHash(values->data(), values->size() * sizeof(float), hash);
+    }
+    return hash;
+}
+
 /* GLFW callback function for keyboard events */
 void callbackKey(GLFWwindow *window, int key, int scancode, int action, int mods) {
     /* called on keyboard event */
@@ -49,12 +244,18 @@ void callbackKey(GLFWwindow *window, int key, int scancode, int action, int mods
         glfwSetWindowShouldClose(window, true);
     }
 
-    /* make screenshot and save in work directory */
+    /* make screenshot and save in work directory (read back after the next frame is drawn) */
     if (key == GLFW_KEY_P && action == GLFW_PRESS) {
-        screenshotToPNG("screenshot.png");
+        sScene.screenshotRequested = true;
+    }
+
+    /* a replay only takes car and camera input from the log */
+    if (sScene.inputReplaying) {
+        return;
     }
 
     /* input for car control */
+    unsigned int buttons = inputButtonMask();
     if (key == GLFW_KEY_W) {
         sInput.buttonPressed[0] = (action == GLFW_PRESS || action == GLFW_REPEAT);
     }
@@ -67,25 +268,93 @@ void callbackKey(GLFWwindow *window, int key, int scancode, int action, int mods
     if (key == GLFW_KEY_D) {
         sInput.buttonPressed[3] = (action == GLFW_PRESS || action == GLFW_REPEAT);
     }
+    if (inputButtonMask() != buttons) {
+        inputRecord(InputEventButtons, static_cast<float>(inputButtonMask()));
+    }
 
     /* camera mode 1*/
     if (key == GLFW_KEY_1 && action == GLFW_PRESS) {
-        sScene.cameraFollowPickup = false;
-        sScene.camera.lookAt = {0.0f, 0.0f, 0.0f};
+        inputCameraMode(1);
     }
 
     /* camera mode 2*/
     if (key == GLFW_KEY_2 && action == GLFW_PRESS) {
-        sScene.cameraFollowPickup = true;
+        inputCameraMode(2);
+    }
+
+    /* toggle checkerboard shading (selects another shader variant) */
+    if (key == GLFW_KEY_C && action == GLFW_PRESS) {
+        sScene.checkerboard = !sScene.checkerboard;
+    }
+
+    /* cycle through the view layouts (single, minimap, split screen) */
+    if (key == GLFW_KEY_V && action == GLFW_PRESS) {
+        static const char *names[] = {"single", "minimap", "split"};
+        sScene.viewLayout = (sScene.viewLayout + 1) % ViewLayoutCount;
+        std::cout << "[Views] " << names[sScene.viewLayout] << std::endl;
+    }
+
+    /* toggle occlusion culling */
+    if (key == GLFW_KEY_O && action == GLFW_PRESS) {
+        sScene.occlusionEnabled = !sScene.occlusionEnabled;
+        std::cout << "[Occlusion] " << (sScene.occlusionEnabled ? "enabled" : "disabled") << std::endl;
+    }
+
+    /* start/stop recording every frame (to --record PATH or recording.y4m) */
+    if (key == GLFW_KEY_R && action == GLFW_PRESS) {
+        if (captureIsRecording(sScene.capture)) {
+            captureStopRecording(sScene.capture);
+        } else {
+            std::string path = sOptions.recordPath.empty() ? "recording.y4m" : sOptions.recordPath;
+            captureStartRecording(sScene.capture, path, captureFormatFromPath(path), sOptions.recordFps);
+        }
+    }
+
+    /* print statistics of the last frame */
+    if (key == GLFW_KEY_I && action == GLFW_PRESS) {
+        const OcclusionStats &occ = sScene.occlusion.stats;
+        std::cout << "[Culling] " << sScene.drawList.cullStats.culled << " of " << sScene.drawList.cullStats.tested << " objects culled" << std::endl;
+        std::cout << "[MeshBuffer] " << meshBufferSummary(sScene.meshBuffer) << std::endl;
+        FrameArenaStats arena = frameArenaStats(sScene.frameArena);
+        std::cout << "[FrameArena] " << arena.used / 1024 << " KiB used last frame, high-water " << arena.highWater / 1024
+                  << " KiB of " << arena.capacity / 1024 << " KiB in " << sScene.frameArena.subArenas.size() << " sub-arenas, "
+                  << arena.overflowAllocations << " heap fallbacks" << std::endl;
+        if (ALLOC_TRACKING_AVAILABLE) {
+            std::cout << "[Alloc] last frame: " << sScene.allocFrame.allocations << " allocations (" << sScene.allocFrame.bytes
+                      << " B), " << sScene.allocFrame.frees << " frees" << std::endl;
+        }
+        std::vector<unsigned int> nearby;
+        spatialHashQueryRadius(sScene.broadphase, sScene.vehiclePositions[0], 50.0f, nearby);
+        std::cout << "[Broadphase] " << sScene.vehiclePositions.size() << " vehicles, " << sScene.vehicleContacts.size()
+                  << " pairs with overlapping bounds, " << nearby.size() - 1 << " vehicles within 50 m of the driven pickup" << std::endl;
+        const LodStats &lod = sScene.drawList.lodStats;
+        std::cout << "[LOD] " << lod.selected << " instances, " << lod.trianglesDrawn << " triangles drawn instead of "
+                  << lod.trianglesFull << " at the finest level" << std::endl;
+        std::cout << "[Occlusion] " << occ.occluded << " of " << occ.tested << " vehicles occluded, GPU draw time "
+                  << occ.gpuTimeOn << " ms with / " << occ.gpuTimeOff << " ms without queries";
+        if (occ.gpuTimeOn > 0.0 && occ.gpuTimeOff > 0.0) {
+            std::cout << " (saved " << occ.gpuTimeOff - occ.gpuTimeOn << " ms)";
+        }
+        std::cout << std::endl;
+        std::cout << "[Frame] " << frameHistogramSummary(sScene.frameTimes) << std::endl;
+        std::cout << "[Update] " << frameHistogramSummary(sScene.updateTimes) << std::endl;
+        std::cout << "[Simulation] " << sScene.simSteps << " steps of " << 1000.0 * sScene.simStep << " ms, "
+                  << sScene.simDroppedTime << " s dropped (more than " << sScene.simMaxSteps << " steps per frame)" << std::endl;
+        if (sScene.resolutionScaling) {
+            const DynamicResolution &res = sScene.resolution;
+            std::cout << "[Resolution] Scale " << res.scale << " (" << res.width << "x" << res.height << " of "
+                      << res.outputWidth << "x" << res.outputHeight << "), GPU frame " << res.gpuTimeMs << " ms, budget "
+                      << res.budgetMs << " ms" << std::endl;
+        }
     }
 }
 
 /* GLFW callback function for mouse position events */
 void callbackMousePos(GLFWwindow *window, double x, double y) {
     /* called on cursor position change */
-    if (sInput.mouseLeftButtonPressed) {
+    if (sInput.mouseLeftButtonPressed && !sScene.inputReplaying) {
         Vector2D diff = sInput.mousePressStart - Vector2D(x, y);
-        cameraUpdateOrbit(sScene.camera, diff, 0.0f);
+        inputCameraOrbit(diff, 0.0f);
         sInput.mousePressStart = Vector2D(x, y);
     }
 }
@@ -103,7 +372,9 @@ void callbackMouseButton(GLFWwindow *window, int button, int action, int mods) {
 
 /* GLFW callback function for mouse scroll events */
 void callbackMouseScroll(GLFWwindow *window, double xoffset, double yoffset) {
-    cameraUpdateOrbit(sScene.camera, {0, 0}, -sScene.zoomSpeedMultiplier * yoffset);
+    if (!sScene.inputReplaying) {
+        inputCameraOrbit({0, 0}, -sScene.zoomSpeedMultiplier * static_cast<float>(yoffset));
+    }
 }
 
 /* GLFW callback function for window resize event */
@@ -111,11 +382,199 @@ void callbackWindowResize(GLFWwindow *window, int width, int height) {
     glViewport(0, 0, width, height);
     sScene.camera.width = width;
     sScene.camera.height = height;
+
+    /* the offscreen target follows the window, the render resolution stays a fraction of it */
+    if (sScene.resolutionScaling) {
+        dynamicResolutionResize(sScene.resolution, width, height);
+    }
+}
+
+/* adds a vehicle that drives in circles, speed and turning radius differ from vehicle to vehicle */
+void fleetAddCircling(Fleet &fleet, float x, float z, float heading) {
+    unsigned int i = fleetAdd(fleet, x, z, heading);
+    fleet.throttle[i] = 0.4f + 0.6f * std::fmod(0.618f * i, 1.0f);
+    fleet.steerInput[i] = (i % 2 ? 1.0f : -1.0f) * (0.3f + 0.7f * std::fmod(0.383f * i, 1.0f));
+}
+
+/* pickup with meshes that only carry the bounds of the real geometry (no GL objects), so the benchmarks run without a
+ * context and still get the size of a real vehicle */
+Pickup benchmarkPrototype(SceneGraph &sceneGraph) {
+    auto boundsMesh = [](const auto &positions) {
+        std::vector<Vertex> vertices(positions.size());
+        for (std::size_t i = 0; i < positions.size(); i++) {
+            vertices[i].pos = positions[i];
+        }
+        Mesh mesh;
+        meshComputeBounds(mesh, vertices);
+        return mesh;
+    };
+    Mesh cube = boundsMesh(cube::vertexPos);
+    return pickupCreate(sceneGraph, cube, cube, boundsMesh(cylinder::vertexPos));
+}
+
+/* --fleet-benchmark: time per simulation step of N vehicles, per-pickup update (pickupUpdate +
+ * pickupAdjustToTerrain) against the fleet on one thread and on the worker pool; needs no window */
+void fleetBenchmark(unsigned int numVehicles) {
+    using Clock = std::chrono::steady_clock;
+    const float dt = 1.0f / 60.0f;
+    const unsigned int steps = 100;
+
+    SceneGraph sceneGraph;
+    Ground ground;
+    Pickup prototype = benchmarkPrototype(sceneGraph);
+    float maxSteering = to_radians(30.0f);
+    float turning = calculateTurningAnglePerMeter(prototype.wheelBase, maxSteering, prototype.width);
+    FleetParams params = fleetParamsCreate(prototype, ground, 5.0f, maxSteering, turning);
+
+    unsigned int gridSize = static_cast<unsigned int>(std::ceil(std::sqrt(static_cast<double>(numVehicles))));
+    Fleet fleet;
+    std::vector<Pickup> pickups(numVehicles, prototype);
+    for (unsigned int i = 0; i < numVehicles; i++) {
+        float x = (static_cast<float>(i % gridSize) - 0.5f * gridSize) * 12.0f;
+        float z = (static_cast<float>(i / gridSize) - 0.5f * gridSize) * 12.0f;
+        fleetAddCircling(fleet, x, z, 0.7f * i);
+        pickups[i].vehicleTransform = Matrix4D::translation({x, 0.0f, z}) * Matrix4D::rotationY(0.7f * i);
+    }
+
+    auto msPerStep = [steps](Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count() / steps;
+    };
+
+    Clock::time_point start = Clock::now();
+    for (unsigned int step = 0; step < steps; step++) {
+        for (auto &pickup : pickups) {
+            pickupUpdate(pickup, params.maxSpeed, maxSteering, turning, dt, true, false, true, false);
+            pickupAdjustToTerrain(pickup, ground);
+        }
+    }
+    double pickupMs = msPerStep(start);
+    pickups.clear();
+
+    start = Clock::now();
+    for (unsigned int step = 0; step < steps; step++) {
+        fleetStep(fleet, params, dt);
+    }
+    double serialMs = msPerStep(start);
+
+    ThreadPool pool = threadPoolCreate();
+    start = Clock::now();
+    for (unsigned int step = 0; step < steps; step++) {
+        fleetStep(fleet, params, dt, &pool);
+    }
+    double parallelMs = msPerStep(start);
+
+    std::cout << "[Fleet] " << numVehicles << " vehicles, " << steps << " steps" << std::endl;
+    std::cout << "[Fleet] pickups (AoS):     " << pickupMs << " ms/step" << std::endl;
+    std::cout << "[Fleet] fleet, 1 thread:   " << serialMs << " ms/step (" << pickupMs / serialMs << "x)" << std::endl;
+    std::cout << "[Fleet] fleet, " << threadPoolSize(pool) << " threads: " << parallelMs << " ms/step ("
+              << pickupMs / parallelMs << "x)" << std::endl;
+    threadPoolDelete(pool);
+}
+
+/* rebuilds the broadphase from the vehicle positions of the current simulation step */
+void sceneUpdateBroadphase() {
+    sScene.vehiclePositions.resize(sScene.pickups.size());
+    for (unsigned int i = 0; i < sScene.pickups.size(); i++) {
+        sScene.vehiclePositions[i] = i > 0 && sScene.fleetDriving
+            ? Vector3D(sScene.fleet.posX[i - 1], sScene.fleet.posY[i - 1], sScene.fleet.posZ[i - 1])
+            : pickupGetWorldPosition(sScene.pickups[i]);
+    }
+    spatialHashBuild(sScene.broadphase, sScene.vehiclePositions, &sScene.workers);
+    spatialHashQueryPairs(sScene.broadphase, 2.0f * sScene.vehicleRadius, sScene.vehicleContacts, &sScene.workers);
+}
+
+/* --broadphase-benchmark: rebuild + all overlapping pairs per step for N moving vehicles (a circling fleet), on one
+ * thread and on the worker pool, against testing all pairs for up to 20000 vehicles; needs no window */
+void broadphaseBenchmark(unsigned int numVehicles) {
+    using Clock = std::chrono::steady_clock;
+    const float dt = 1.0f / 60.0f;
+    const unsigned int steps = 50;
+
+    SceneGraph sceneGraph;
+    Ground ground;
+    Pickup prototype = benchmarkPrototype(sceneGraph);
+    float maxSteering = to_radians(30.0f);
+    float turning = calculateTurningAnglePerMeter(prototype.wheelBase, maxSteering, prototype.width);
+    FleetParams params = fleetParamsCreate(prototype, ground, 5.0f, maxSteering, turning);
+    float radius = std::max(length(prototype.boundsMin), length(prototype.boundsMax));
+
+    /* dense enough that neighbouring vehicles touch now and then */
+    unsigned int gridSize = static_cast<unsigned int>(std::ceil(std::sqrt(static_cast<double>(numVehicles))));
+    Fleet fleet;
+    for (unsigned int i = 0; i < numVehicles; i++) {
+        fleetAddCircling(fleet, (static_cast<float>(i % gridSize) - 0.5f * gridSize) * 2.2f * radius,
+                         (static_cast<float>(i / gridSize) - 0.5f * gridSize) * 2.2f * radius, 0.7f * i);
+    }
+
+    ThreadPool pool = threadPoolCreate();
+    SpatialHash hash = spatialHashCreate(2.0f * radius);
+    SpatialHashPairs pairs;
+    std::vector<Vector3D> positions(numVehicles);
+    double buildMs[2] = {0.0, 0.0}, pairsMs[2] = {0.0, 0.0};
+    unsigned long long numPairs = 0;
+    AllocFrameStats allocations;
+    for (unsigned int step = 0; step < steps; step++) {
+        /* the first step sizes all buffers, the others shouldn't allocate */
+        if (step == 1) {
+            allocTrackingEndFrame();
+            allocTrackingRecordSites(true);
+        }
+        ALLOC_SCOPE("broadphaseBenchmark");
+        fleetStep(fleet, params, dt, &pool);
+        for (unsigned int i = 0; i < numVehicles; i++) {
+            positions[i] = Vector3D(fleet.posX[i], fleet.posY[i], fleet.posZ[i]);
+        }
+
+        for (int parallel = 0; parallel < 2; parallel++) {
+            ThreadPool *workers = parallel ? &pool : nullptr;
+            Clock::time_point start = Clock::now();
+            spatialHashBuild(hash, positions, workers);
+            Clock::time_point built = Clock::now();
+            spatialHashQueryPairs(hash, 2.0f * radius, pairs, workers);
+            buildMs[parallel] += std::chrono::duration<double, std::milli>(built - start).count() / steps;
+            pairsMs[parallel] += std::chrono::duration<double, std::milli>(Clock::now() - built).count() / steps;
+        }
+        numPairs += pairs.size();
+    }
+    allocTrackingRecordSites(false);
+    allocations = allocTrackingEndFrame();
+
+    std::cout << "[Broadphase] " << numVehicles << " vehicles, " << steps << " steps, " << numPairs / steps << " pairs per step" << std::endl;
+    std::cout << "[Broadphase] 1 thread:   build " << buildMs[0] << " ms, pairs " << pairsMs[0] << " ms" << std::endl;
+    std::cout << "[Broadphase] " << threadPoolSize(pool) << " threads: build " << buildMs[1] << " ms, pairs " << pairsMs[1] << " ms" << std::endl;
+    if (ALLOC_TRACKING_AVAILABLE) {
+        std::cout << "[Alloc] " << static_cast<double>(allocations.allocations) / (steps - 1) << " allocations per step after the first" << std::endl;
+        std::cout << allocTrackingReport(10);
+    }
+
+    /* the last step once more with all pairs tested, the result has to be the same */
+    if (numVehicles <= 20000) {
+        float distanceSq = 4.0f * radius * radius;
+        unsigned long long bruteForcePairs = 0;
+        Clock::time_point start = Clock::now();
+        for (unsigned int i = 0; i < numVehicles; i++) {
+            for (unsigned int j = i + 1; j < numVehicles; j++) {
+                Vector3D d = positions[i] - positions[j];
+                bruteForcePairs += dot(d, d) <= distanceSq ? 1 : 0;
+            }
+        }
+        double bruteForceMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        std::cout << "[Broadphase] all pairs:  " << bruteForceMs << " ms, " << bruteForcePairs << " pairs ("
+                  << (bruteForcePairs == pairs.size() ? "matches" : "MISMATCH") << ")" << std::endl;
+    }
+    threadPoolDelete(pool);
 }
 
 /* function to setup and initialize the whole scene */
 void sceneInit(float width, float height) {
 
+    /* load shader sources from file and submit all variants first, the driver compiles them while the scene is set up */
+    double shaderStart = glfwGetTime();
+    sScene.shaderColor = shaderVariantsLoad("shader/default.vert", "shader/default.frag", {"CHECKERBOARD"});
+    sScene.shaderColor.cacheDir = sOptions.shaderCacheDir;
+    shaderVariantsPrepare(sScene.shaderColor, {0u, ShaderFeatureCheckerboard});
+    sScene.checkerboard = false;
+
     /* initialize camera */
     sScene.camera = cameraCreate(
         width,
@@ -129,40 +588,147 @@ void sceneInit(float width, float height) {
     sScene.cameraFollowPickup = false;
     sScene.zoomSpeedMultiplier = 0.05f;
 
+    sScene.viewLayout = sOptions.viewLayout % ViewLayoutCount;
+    sScene.views = viewSetCreate();
+
     /* Colors */
     Vector3D colorGround  = {0.15f, 0.45f, 0.15f};
     Vector4D colorBase    = {0.1f, 0.1f, 0.5f, 1.0f};
     Vector4D colorCockpit = {0.1f, 0.1f, 0.8f, 1.0f};
     Vector4D colorWheels  = {0.15f, 0.15f, 0.15f, 1.0f};
 
-    /* setup objects in scene and create opengl buffers for meshes */
+    /* setup objects in scene and create opengl buffers for meshes, static meshes share one vertex/index buffer */
+    sScene.meshBuffer = meshBufferCreate(1 << 16, 1 << 18);
     sScene.ground = groundCreate(colorGround);
-    sScene.pickup = pickupCreate(colorBase, colorCockpit, colorWheels);
+
+    /* vehicle and occlusion box meshes from the baked pack if there is one, it is mapped and uploaded as is */
+    std::vector<Mesh> packMeshes;
+    int packBase = -1, packCockpit = -1, packWheel = -1, packCube = -1;
+    MeshPack pack;
+    if (!sOptions.meshPackPath.empty() && meshPackOpen(sOptions.meshPackPath, pack)) {
+        packBase = meshPackFind(pack, "pickup.base");
+        packCockpit = meshPackFind(pack, "pickup.cockpit");
+        packWheel = meshPackFind(pack, "pickup.wheel");
+        packCube = meshPackFind(pack, "cube");
+        if (packBase >= 0 && packCockpit >= 0 && packWheel >= 0 && packCube >= 0) {
+            packMeshes = meshBufferAddPack(sScene.meshBuffer, pack, {packBase, packCockpit, packWheel, packCube});
+        } else {
+            std::cerr << "[MeshPack] " << sOptions.meshPackPath << " lacks the vehicle meshes" << std::endl;
+        }
+        meshPackClose(pack);
+    }
+    if (packMeshes.empty()) {
+        std::cout << "[MeshPack] Using the built-in geometry" << std::endl;
+        sScene.pickups.push_back(pickupCreate(sScene.meshBuffer, sScene.sceneGraph, colorBase, colorCockpit, colorWheels));
+    } else {
+        sScene.pickups.push_back(pickupCreate(sScene.sceneGraph, packMeshes[0], packMeshes[1], packMeshes[2]));
+    }
+
+    /* wheel levels of detail with 4, 8, 16 and 32 segments, the 8 segment level is the mesh the pickups already use */
+    MeshLod wheelLod;
+    wheelLod.source = sScene.pickups[0].wheels[0];
+    wheelLod.levels = {
+        meshBufferAdd(sScene.meshBuffer, cylinder::makeVertexPos<4>(), cylinder::makeIndices<4>(), colorWheels),
+        wheelLod.source,
+        meshBufferAdd(sScene.meshBuffer, cylinder::makeVertexPos<16>(), cylinder::makeIndices<16>(), colorWheels),
+        meshBufferAdd(sScene.meshBuffer, cylinder::makeVertexPos<32>(), cylinder::makeIndices<32>(), colorWheels)
+    };
+    wheelLod.errors = {lodCylinderError(4), lodCylinderError(8), lodCylinderError(16), lodCylinderError(32)};
+    sScene.lods.assign(1, wheelLod);
+
+    /* parked pickups on a square grid around the origin, sharing the meshes of the first pickup */
+    unsigned int gridSize = static_cast<unsigned int>(std::ceil(std::sqrt(sOptions.numParkedPickups + 1.0)));
+    float spacing = 12.0f;
+    for (unsigned int i = 1; i <= sOptions.numParkedPickups; i++) {
+        Vector3D pos((static_cast<float>(i % gridSize) - 0.5f * gridSize) * spacing, 0.0f, (static_cast<float>(i / gridSize) - 0.5f * gridSize) * spacing);
+        Matrix4D transform = Matrix4D::translation(pos) * Matrix4D::rotationY(0.7f * i);
+
+        Pickup parked = pickupCreateInstance(sScene.pickups[0], sScene.sceneGraph, transform);
+        pickupAdjustToTerrain(parked, sScene.ground);
+        pickupUpdateSceneGraph(parked, sScene.sceneGraph);
+        sScene.pickups.push_back(parked);
+    }
+
+    /* unit cube for the occlusion queries, lives in the mesh buffer so it shares the VAO with the vehicles */
+    sScene.occlusionEnabled = false;
+    sScene.occlusion = occlusionCreate();
+    sScene.occlusionBox = packMeshes.empty()
+        ? meshBufferAdd(sScene.meshBuffer, cube::vertexPos, cube::indices, Vector4D(1.0f, 1.0f, 1.0f, 1.0f))
+        : packMeshes[3];
+
+    sScene.frameTimes = frameHistogramCreate();
+    sScene.updateTimes = frameHistogramCreate();
+
+    sScene.capture = captureCreate();
+    sScene.screenshotRequested = false;
+
+    /* one worker per hardware thread for frame preparation */
+    sScene.workers = threadPoolCreate();
+    sScene.workerLists.resize(threadPoolSize(sScene.workers) + 1);
+    sScene.frameArena = frameArenaCreate(threadPoolSize(sScene.workers) + 1, std::size_t(sOptions.frameArenaKiB) * 1024);
 
     /* Fahr-Parameter für Aufgabe 2 */
     sScene.moveSpeed           = 5.0f;                 // „vordefinierte Velocity“
     sScene.maxSteeringAngleRad = to_radians(30.0f);
     sScene.turningAnglePerMeterDeg =
         calculateTurningAnglePerMeter(
-            sScene.pickup.wheelBase,
+            sScene.pickups[0].wheelBase,
             sScene.maxSteeringAngleRad,
-            sScene.pickup.width
+            sScene.pickups[0].width
         );
 
-    /* load shader from file */
-    sScene.shaderColor = shaderLoad("shader/default.vert", "shader/default.frag");
+    /* the parked pickups keep their meshes and scene graph nodes, their motion comes from the fleet */
+    sScene.fleetDriving = sOptions.driveParked;
+    sScene.fleet = Fleet();
+    if (sScene.fleetDriving) {
+        sScene.fleetParams = fleetParamsCreate(sScene.pickups[0], sScene.ground, sScene.moveSpeed, sScene.maxSteeringAngleRad, sScene.turningAnglePerMeterDeg);
+        for (unsigned int i = 1; i < sScene.pickups.size(); i++) {
+            const Matrix4D &transform = sScene.pickups[i].vehicleTransform;
+            fleetAddCircling(sScene.fleet, transform(0, 3), transform(2, 3), std::atan2(-transform(2, 0), transform(0, 0)));
+        }
+        /* two steps without time fit the start positions (and the previous state) to the terrain */
+        fleetStep(sScene.fleet, sScene.fleetParams, 0.0f);
+        fleetStep(sScene.fleet, sScene.fleetParams, 0.0f);
+    }
+
+    /* bounding sphere of a vehicle around its origin, the grid cells are one sphere diameter wide */
+    sScene.vehicleRadius = std::max(length(sScene.pickups[0].boundsMin), length(sScene.pickups[0].boundsMax));
+    sScene.broadphase = spatialHashCreate(2.0f * sScene.vehicleRadius);
+    sceneUpdateBroadphase();
+
+    sScene.simStep = 1.0 / (sOptions.simRate > 0.0 ? sOptions.simRate : 60.0);
+    sScene.simMaxSteps = sOptions.simMaxSteps > 0 ? sOptions.simMaxSteps : 1;
+    sScene.simAccumulator = 0.0;
+    sScene.pickupPrevious = pickupGetState(sScene.pickups[0]);
+    sScene.simSteps = 0;
+    sScene.simDroppedTime = 0.0;
+
+    /* all variants are compiled by now, status checks only had to wait for whatever the driver hadn't finished yet */
+    shaderVariant(sScene.shaderColor, 0u);
+    shaderVariant(sScene.shaderColor, ShaderFeatureCheckerboard);
+
+    const ShaderCacheStats &cache = sScene.shaderColor.cacheStats;
+    std::cout << "[Shader] Built " << sScene.shaderColor.programs.size() << " programs in "
+              << (glfwGetTime() - shaderStart) * 1000.0 << " ms";
+    if (!sOptions.shaderCacheDir.empty() && cache.unsupported > 0) {
+        std::cout << " (cache unsupported: the driver has no program binary formats)";
+    } else if (!sOptions.shaderCacheDir.empty()) {
+        std::cout << " (cache hits: " << cache.hits << ", misses: " << cache.misses << ", rejected: " << cache.rejected << ")";
+    }
+    std::cout << std::endl;
 }
 
-/* function to move and update objects in scene (e.g., move car according to user input) */
-void sceneUpdate(float dt) {
+/* one fixed simulation step of the driven pickup (and of the fleet) */
+void sceneStep(float dt) {
     bool moveForward  = sInput.buttonPressed[0]; // W
     bool moveBackward = sInput.buttonPressed[1]; // S
     bool turnLeft     = sInput.buttonPressed[3]; // A
     bool turnRight    = sInput.buttonPressed[2]; // D
 
     // Pickup-Bewegung (Aufgabe 2)
+    Pickup &pickup = sScene.pickups[0];
     pickupUpdate(
-        sScene.pickup,
+        pickup,
         sScene.moveSpeed,
         sScene.maxSteeringAngleRad,
         sScene.turningAnglePerMeterDeg,
@@ -173,30 +739,242 @@ void sceneUpdate(float dt) {
         turnRight
     );
 
-    pickupAdjustToTerrain(sScene.pickup, sScene.ground);
+    pickupAdjustToTerrain(pickup, sScene.ground);
+
+    if (sScene.fleetDriving) {
+        fleetStep(sScene.fleet, sScene.fleetParams, dt, &sScene.workers);
+    }
+    sceneUpdateBroadphase();
+}
+
+/* function to move and update objects in scene (e.g., move car according to user input) */
+void sceneUpdate(float dt) {
+    PROFILE_CPU("sceneUpdate");
+
+    /* advance the simulation in fixed steps, a slow frame runs a bounded number of steps instead of one huge one */
+    Pickup &pickup = sScene.pickups[0];
+    sScene.simAccumulator += dt;
+    unsigned int steps = 0;
+    while (sScene.simAccumulator >= sScene.simStep && steps < sScene.simMaxSteps) {
+        if (sScene.inputReplaying) {
+            InputEvent event;
+            while (inputLogNext(sScene.inputLog, static_cast<std::uint32_t>(sScene.simSteps), event)) {
+                inputApply(event);
+            }
+        }
+
+        sScene.pickupPrevious = pickupGetState(pickup);
+        sceneStep(static_cast<float>(sScene.simStep));
+        sScene.simAccumulator -= sScene.simStep;
+        sScene.simSteps++;
+        steps++;
+    }
+
+    /* couldn't catch up: drop the remaining time, the simulation runs slower than real time until the load is gone */
+    if (sScene.simAccumulator >= sScene.simStep) {
+        sScene.simDroppedTime += sScene.simAccumulator - std::fmod(sScene.simAccumulator, sScene.simStep);
+        sScene.simAccumulator = std::fmod(sScene.simAccumulator, sScene.simStep);
+    }
+
+    /* render between the last two simulation states, only mark the changed nodes (world matrices are recomputed
+     * during frame preparation) */
+    float alpha = static_cast<float>(sScene.simAccumulator / sScene.simStep);
+    PickupState shown = pickupInterpolate(sScene.pickupPrevious, pickupGetState(pickup), alpha);
+    pickupUpdateSceneGraph(pickup, shown, sScene.sceneGraph);
+    for (unsigned int i = 0; i < fleetSize(sScene.fleet); i++) {
+        pickupUpdateSceneGraph(sScene.pickups[i + 1], fleetGetState(sScene.fleet, i, alpha), sScene.sceneGraph);
+    }
 
     /* if camera mode 2 is activated, set the camera focus to the pos of the pickup*/
     if (sScene.cameraFollowPickup) {
-        sScene.camera.lookAt = pickupGetWorldPosition(sScene.pickup);
+        Vector4D position = shown.vehicleTransform[3];
+        sScene.camera.lookAt = Vector3D(position.x, position.y, position.z);
+    }
+}
+
+/* views of the frame for the current layout, view 0 is always the main camera (LOD and occlusion refer to it) */
+void sceneBuildViews() {
+    ViewSet &set = sScene.views;
+    const Camera &camera = sScene.camera;
+    viewSetClear(set);
+
+    float aspect = camera.width / camera.height;
+    float mainWidth = sScene.viewLayout == ViewLayoutSplit ? 0.5f : 1.0f;
+    viewSetAdd(set, cameraView(camera), Matrix4D::perspective(camera.fov, aspect * mainWidth, camera.nearPlane, camera.farPlane), 0.0f, 0.0f, mainWidth, 1.0f);
+
+    /* the driven pickup as shown this frame (root node, local = world) */
+    const Matrix4D &vehicle = sScene.sceneGraph.local[sScene.pickups[0].nodeVehicle];
+    Vector4D position = vehicle * Vector4D(0.0f, 0.0f, 0.0f, 1.0f);
+    Vector3D center(position.x, position.y, position.z);
+
+    if (sScene.viewLayout == ViewLayoutSplit) {
+        /* behind and above the vehicle, looking along its forward axis */
+        Vector4D eye = vehicle * Vector4D(-16.0f, 7.0f, 0.0f, 1.0f);
+        Vector4D target = vehicle * Vector4D(4.0f, 2.0f, 0.0f, 1.0f);
+        Camera follow = cameraCreate(0.5f * camera.width, camera.height, camera.fov, camera.nearPlane, camera.farPlane,
+                                     Vector3D(eye.x, eye.y, eye.z), Vector3D(target.x, target.y, target.z));
+        viewSetAdd(set, cameraView(follow), cameraProjection(follow), 0.5f, 0.0f, 0.5f, 1.0f);
     }
+
+    if (sScene.viewLayout == ViewLayoutMinimap || sScene.viewLayout == ViewLayoutSplit) {
+        /* square in the top right corner, 120 m around the driven pickup seen from straight above */
+        float height = 0.3f;
+        float width = height / aspect;
+        float halfExtent = 60.0f;
+        Camera top = cameraCreate(1.0f, 1.0f, camera.fov, 1.0f, 500.0f, center + Vector3D(0.0f, 250.0f, 0.0f), center, Vector3D(0.0f, 0.0f, -1.0f));
+        viewSetAdd(set, cameraView(top), Matrix4D::ortho(-halfExtent, -halfExtent, halfExtent, halfExtent, top.nearPlane, top.farPlane),
+                   1.0f - width - 0.02f, 1.0f - height - 0.02f, width, height);
+    }
+    viewSetFrustums(set, sScene.viewFrustums);
+}
+
+/* function to build the draw list of the frame on the worker threads (no GL calls) */
+void scenePrepare() {
+    PROFILE_CPU("scenePrepare");
+    sceneBuildViews();
+
+    for (auto &list : sScene.workerLists) {
+        drawListClear(list);
+    }
+
+    /* each worker handles a contiguous range of pickups: world matrices of their subtrees, draw items, culling, LOD,
+     * commands and sorting, all once for every view, only the frustum test runs per view */
+    threadPoolParallelFor(sScene.workers, sScene.pickups.size(), [](unsigned int begin, unsigned int end, unsigned int worker) {
+        PROFILE_CPU("prepareChunk");
+        FrameVector<DrawItem> items{FrameAllocator<DrawItem>(frameArenaSub(sScene.frameArena, worker))};
+        items.reserve(PICKUP_DRAW_ITEMS * (end - begin));
+        DrawList &list = sScene.workerLists[worker];
+
+        /* every pickup owns exactly one scene graph root, in creation order */
+        sceneGraphUpdateRoots(sScene.sceneGraph, begin, end);
+        for (unsigned int i = begin; i < end; i++) {
+            pickupCollectDrawItems(sScene.pickups[i], sScene.sceneGraph, i, items);
+        }
+
+        cullDrawItems(sScene.viewFrustums, items, list.cullStats);
+        lodSelect(sScene.camera, sScene.lods, sOptions.lodTolerance, items, list.lodStats);
+        for (const auto &item : items) {
+            drawListAdd(list, item);
+        }
+        drawListSort(list);
+    });
+
+    /* the last list belongs to the main thread, it holds the objects outside of the scene graph (ground) */
+    FrameVector<DrawItem> items{FrameAllocator<DrawItem>(frameArenaSub(sScene.frameArena, threadPoolSize(sScene.workers)))};
+    DrawList &list = sScene.workerLists.back();
+    items.assign(1, {sScene.ground.mesh, Matrix4D::identity()});
+    cullDrawItems(sScene.viewFrustums, items, list.cullStats);
+    for (const auto &item : items) {
+        drawListAdd(list, item);
+    }
+
+    drawListMerge(sScene.workerLists, sScene.drawList);
 }
 
 /* function to draw all objects in the scene */
 void sceneDraw() {
+    PROFILE_CPU("sceneDraw");
     glClearColor(135.0f / 255, 206.0f / 255, 235.0f / 255, 1.0);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    glUseProgram(sScene.shaderColor.id);
-    shaderUniform(sScene.shaderColor, "uProj", cameraProjection(sScene.camera));
-    shaderUniform(sScene.shaderColor, "uView", cameraView(sScene.camera));
+    ShaderProgram &shader = shaderVariant(sScene.shaderColor, sScene.checkerboard ? ShaderFeatureCheckerboard : 0u);
+    glUseProgram(shader.id);
 
-    // Draw ground
-    shaderUniform(sScene.shaderColor, "uModel", Matrix4D::identity());
-    glBindVertexArray(sScene.ground.mesh.vao);
-    glDrawElements(GL_TRIANGLES, sScene.ground.mesh.size_ibo, GL_UNSIGNED_INT, nullptr);
+    /* matrices of all views in one upload, the viewports are fractions of the current target (which is smaller than
+     * the window with dynamic resolution) */
+    viewSetUpload(sScene.views);
+    GLint target[4];
+    glGetIntegerv(GL_VIEWPORT, target);
 
-    // Draw pickup
-    pickupDraw(sScene.pickup, sScene.shaderColor);
+    const DrawList &list = sScene.drawList;
+    occlusionBeginFrame(sScene.occlusion, sScene.pickups.size(), sScene.occlusionEnabled);
+
+    /* the sorted list starts with the commands without object (terrain), the vehicles follow */
+    std::size_t objectsBegin = drawListObjectsBegin(list);
+    GLuint boundVao = 0;
+
+    /* conditional rendering needs the commands per object: they are contiguous, collect the ranges and the views that
+     * see any part */
+    struct Range { unsigned int object; std::size_t begin, end; unsigned int viewMask; bool tested; };
+    FrameVector<Range> ranges{FrameAllocator<Range>(frameArenaSub(sScene.frameArena, threadPoolSize(sScene.workers)))};
+    if (sScene.occlusionEnabled) {
+        for (std::size_t i = objectsBegin; i < list.commands.size(); i++) {
+            unsigned int object = list.commands[i].object;
+            if (ranges.empty() || ranges.back().object != object) {
+                ranges.push_back({object, i, i, 0u, false});
+            }
+            ranges.back().end = i + 1;
+            ranges.back().viewMask |= list.commands[i].viewMask;
+        }
+    }
+
+    for (unsigned int v = 0; v < sScene.views.views.size(); v++) {
+        unsigned int viewBit = 1u << v;
+        viewSetBind(sScene.views, v, target);
+
+        /* later views may overlap earlier ones (minimap) */
+        if (v > 0) {
+            glEnable(GL_SCISSOR_TEST);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            glDisable(GL_SCISSOR_TEST);
+        }
+
+        /* occluders first (everything that isn't a vehicle, i.e. the terrain) */
+        {
+            PROFILE_CPU("groundDraw");
+            PROFILE_GPU("groundDraw");
+            drawListReplayRange(list, shader, 0, objectsBegin, viewBit, boundVao);
+        }
+
+        /* occlusion queries belong to the main camera */
+        if (!sScene.occlusionEnabled || v > 0) {
+            /* replay the prepared, culled and sorted commands of the vehicles */
+            PROFILE_CPU("pickupDraw");
+            PROFILE_GPU("pickupDraw");
+            drawListReplayRange(list, shader, objectsBegin, list.commands.size(), viewBit, boundVao);
+        } else {
+            /* bounding boxes of the vehicles inside occlusion queries */
+            PROFILE_CPU("pickupDraw");
+            PROFILE_GPU("pickupDraw");
+            glBindVertexArray(sScene.occlusionBox.vao);
+            boundVao = sScene.occlusionBox.vao;
+            for (auto &r : ranges) {
+                if (r.viewMask & viewBit) {
+                    const Pickup &pickup = sScene.pickups[r.object];
+                    const Matrix4D &vehicle = sScene.sceneGraph.world[pickup.nodeVehicle];
+
+                    /* a box around the camera would be clipped by the near plane and report the vehicle as hidden */
+                    Vector4D cam = inverse(vehicle) * Vector4D(sScene.camera.position, 1.0f);
+                    float margin = sScene.camera.nearPlane;
+                    if (cam.x > pickup.boundsMin.x - margin && cam.x < pickup.boundsMax.x + margin
+                        && cam.y > pickup.boundsMin.y - margin && cam.y < pickup.boundsMax.y + margin
+                        && cam.z > pickup.boundsMin.z - margin && cam.z < pickup.boundsMax.z + margin) {
+                        continue;
+                    }
+
+                    Matrix4D boxModel = vehicle
+                        * Matrix4D::translation((pickup.boundsMin + pickup.boundsMax) * 0.5f)
+                        * Matrix4D::scale(0.5f * (pickup.boundsMax.x - pickup.boundsMin.x), 0.5f * (pickup.boundsMax.y - pickup.boundsMin.y), 0.5f * (pickup.boundsMax.z - pickup.boundsMin.z));
+                    occlusionTest(sScene.occlusion, r.object, sScene.occlusionBox, boxModel, shader.modelLocation);
+                    r.tested = true;
+                }
+            }
+
+            /* the vehicles themselves, skipped by the GPU if their box had no visible sample */
+            for (const auto &r : ranges) {
+                if (r.tested) {
+                    occlusionBeginConditional(sScene.occlusion, r.object);
+                    drawListReplayRange(list, shader, r.begin, r.end, viewBit, boundVao);
+                    occlusionEndConditional();
+                } else {
+                    drawListReplayRange(list, shader, r.begin, r.end, viewBit, boundVao);
+                }
+            }
+        }
+    }
+
+    occlusionEndFrame(sScene.occlusion);
+    glViewport(target[0], target[1], target[2], target[3]);
 
     glCheckError();
     glBindVertexArray(0);
@@ -204,10 +982,98 @@ void sceneDraw() {
 }
 
 int main(int argc, char **argv) {
+    /* parse command line */
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--pickups" && i + 1 < argc) {
+            sOptions.numParkedPickups = static_cast<unsigned int>(std::atoi(argv[++i]));
+        } else if (arg == "--shader-cache" && i + 1 < argc) {
+            sOptions.shaderCacheDir = argv[++i];
+        } else if (arg == "--record" && i + 1 < argc) {
+            sOptions.recordPath = argv[++i];
+        } else if (arg == "--record-fps" && i + 1 < argc) {
+            sOptions.recordFps = static_cast<unsigned int>(std::atoi(argv[++i]));
+        } else if (arg == "--headless") {
+            sOptions.headless = true;
+        } else if (arg == "--size" && i + 1 < argc) {
+            std::sscanf(argv[++i], "%dx%d", &sOptions.width, &sOptions.height);
+        } else if (arg == "--frames" && i + 1 < argc) {
+            sOptions.maxFrames = static_cast<unsigned int>(std::atoi(argv[++i]));
+        } else if (arg == "--frame-dt" && i + 1 < argc) {
+            sOptions.frameDt = static_cast<float>(std::atof(argv[++i]));
+        } else if (arg == "--trace" && i + 1 < argc) {
+            sOptions.tracePath = argv[++i];
+        } else if (arg == "--vsync" && i + 1 < argc) {
+            sOptions.vsync = std::string(argv[++i]) != "off";
+        } else if (arg == "--fps" && i + 1 < argc) {
+            sOptions.targetFps = std::atof(argv[++i]);
+        } else if (arg == "--stats-interval" && i + 1 < argc) {
+            sOptions.statsInterval = std::atof(argv[++i]);
+        } else if (arg == "--sim-rate" && i + 1 < argc) {
+            sOptions.simRate = std::atof(argv[++i]);
+        } else if (arg == "--sim-max-steps" && i + 1 < argc) {
+            sOptions.simMaxSteps = static_cast<unsigned int>(std::atoi(argv[++i]));
+        } else if (arg == "--record-input" && i + 1 < argc) {
+            sOptions.inputRecordPath = argv[++i];
+        } else if (arg == "--replay" && i + 1 < argc) {
+            sOptions.replayPath = argv[++i];
+        } else if (arg == "--no-render") {
+            sOptions.noRender = true;
+        } else if (arg == "--frame-budget" && i + 1 < argc) {
+            sOptions.frameBudgetMs = std::atof(argv[++i]);
+        } else if (arg == "--min-scale" && i + 1 < argc) {
+            sOptions.minScale = static_cast<float>(std::atof(argv[++i]));
+        } else if (arg == "--meshes" && i + 1 < argc) {
+            sOptions.meshPackPath = argv[++i];
+        } else if (arg == "--lod-tolerance" && i + 1 < argc) {
+            sOptions.lodTolerance = static_cast<float>(std::atof(argv[++i]));
+        } else if (arg == "--drive-parked") {
+            sOptions.driveParked = true;
+        } else if (arg == "--fleet-benchmark" && i + 1 < argc) {
+            sOptions.fleetBenchmark = static_cast<unsigned int>(std::atoi(argv[++i]));
+        } else if (arg == "--broadphase-benchmark" && i + 1 < argc) {
+            sOptions.broadphaseBenchmark = static_cast<unsigned int>(std::atoi(argv[++i]));
+        } else if (arg == "--frame-arena" && i + 1 < argc) {
+            sOptions.frameArenaKiB = static_cast<unsigned int>(std::atoi(argv[++i]));
+        } else if (arg == "--alloc-warmup" && i + 1 < argc) {
+            sOptions.allocWarmup = static_cast<unsigned int>(std::atoi(argv[++i]));
+        } else if (arg == "--views" && i + 1 < argc) {
+            std::string layout = argv[++i];
+            sOptions.viewLayout = layout == "split" ? ViewLayoutSplit : layout == "minimap" ? ViewLayoutMinimap : ViewLayoutSingle;
+        }
+    }
+
+    if (sOptions.fleetBenchmark > 0) {
+        fleetBenchmark(sOptions.fleetBenchmark);
+        return EXIT_SUCCESS;
+    }
+    if (sOptions.broadphaseBenchmark > 0) {
+        broadphaseBenchmark(sOptions.broadphaseBenchmark);
+        return EXIT_SUCCESS;
+    }
+
+    /* a replay sets up the scene of the recording and runs one simulation step per frame as fast as possible */
+    if (!sOptions.replayPath.empty()) {
+        if (!inputLogLoad(sOptions.replayPath, sScene.inputLog)) {
+            return EXIT_FAILURE;
+        }
+        int driveParked = 0;
+        std::sscanf(sScene.inputLog.scene.c_str(), "pickups=%u drive=%d", &sOptions.numParkedPickups, &driveParked);
+        sOptions.driveParked = driveParked != 0;
+        sOptions.simRate = sScene.inputLog.simRate;
+        sOptions.vsync = false;
+        sOptions.targetFps = 0.0;
+        sScene.inputReplaying = true;
+    } else if (!sOptions.inputRecordPath.empty()) {
+        sScene.inputLog.scene = "pickups=" + std::to_string(sOptions.numParkedPickups) + " drive=" + std::to_string(sOptions.driveParked ? 1 : 0);
+        sScene.inputLog.simRate = sOptions.simRate;
+        sScene.inputRecording = true;
+    }
+
     /* create window/context */
-    int width = 1280;
-    int height = 720;
-    GLFWwindow *window = windowCreate("Assignment 3 - Transformations, User Input and Camera", width, height);
+    int width = sOptions.width;
+    int height = sOptions.height;
+    GLFWwindow *window = windowCreate("Assignment 3 - Transformations, User Input and Camera", width, height, sOptions.headless);
     if (!window) {
         return EXIT_FAILURE;
     }
@@ -219,31 +1085,205 @@ int main(int argc, char **argv) {
     glfwSetScrollCallback(window, callbackMouseScroll);
     glfwSetFramebufferSizeCallback(window, callbackWindowResize);
 
+    /* vsync from the command line, headless frames are never tied to a display */
+    glfwSwapInterval(sOptions.vsync && !sOptions.headless ? 1 : 0);
+
     /*---------- init opengl stuff ------------*/
     glEnable(GL_DEPTH_TEST);
 
+    /* headless: render into an offscreen framebuffer, the application paces frames instead of glfwSwapBuffers */
+    Framebuffer offscreen;
+    FrameFences frameFences;
+    if (sOptions.headless) {
+        offscreen = framebufferCreate(width, height);
+        frameFences = frameFencesCreate();
+        std::cout << "[Headless] Rendering " << width << "x" << height << " offscreen on " << glGetString(GL_RENDERER) << std::endl;
+    }
+
+    /* dynamic resolution renders into its own framebuffer and presents to the window or the headless target */
+    sScene.resolutionScaling = sOptions.frameBudgetMs > 0.0;
+    if (sScene.resolutionScaling) {
+        sScene.resolution = dynamicResolutionCreate(width, height, sOptions.frameBudgetMs, sOptions.minScale);
+    }
+
     /* setup scene */
     sceneInit(width, height);
+    if (!sOptions.recordPath.empty()) {
+        captureStartRecording(sScene.capture, sOptions.recordPath, captureFormatFromPath(sOptions.recordPath), sOptions.recordFps);
+    }
+
+    if (!sOptions.tracePath.empty()) {
+        if (PROFILER_AVAILABLE) {
+            PROFILER_START(sOptions.tracePath);
+        } else {
+            std::cerr << "[Profiler] Not available in this build, --trace ignored" << std::endl;
+        }
+    }
 
     /*-------------- main loop ----------------*/
-    double timeStamp = glfwGetTime();
+    double timeStart = glfwGetTime();
+    double timeStamp = timeStart;
     double timeStampNew = 0.0;
+    double timeStats = timeStart;
+    unsigned int numFrames = 0;
+    FrameLimiter limiter = frameLimiterCreate(sOptions.targetFps);
 
-    /* loop until user closes window */
-    while (!glfwWindowShouldClose(window)) {
+    /* allocations of the setup don't count towards the first frame, without warm-up call sites are recorded from it */
+    if (ALLOC_TRACKING_AVAILABLE) {
+        allocTrackingEndFrame();
+        allocTrackingRecordSites(sOptions.allocWarmup == 0);
+    }
+
+    /* loop until user closes window (or the requested number of frames is rendered, or the replay is over) */
+    while (!glfwWindowShouldClose(window) && (sOptions.maxFrames == 0 || numFrames < sOptions.maxFrames)
+           && !(sScene.inputReplaying && sScene.simSteps >= sScene.inputLog.numSteps)) {
+        double timeFrameStart = glfwGetTime();
         glfwPollEvents();
 
+        /* headless runs advance by a fixed simulated time, so results don't depend on how fast the machine is, a
+         * replay advances exactly one simulation step per frame */
         timeStampNew = glfwGetTime();
-        sceneUpdate(static_cast<float>(timeStampNew - timeStamp));
+        float dt = sOptions.headless ? sOptions.frameDt : static_cast<float>(timeStampNew - timeStamp);
+        sceneUpdate(sScene.inputReplaying ? static_cast<float>(sScene.simStep) : dt);
+        frameHistogramAdd(sScene.updateTimes, 1000.0 * (glfwGetTime() - timeStampNew));
+
+        if (!sOptions.noRender) {
+            /* the transient data of the last frame is no longer used */
+            frameArenaReset(sScene.frameArena);
+            scenePrepare();
+            if (sScene.resolutionScaling) {
+                dynamicResolutionBegin(sScene.resolution);
+            } else if (sOptions.headless) {
+                framebufferBind(offscreen);
+            }
+            sceneDraw();
+            meshBufferEndFrame(sScene.meshBuffer);
+            if (sScene.resolutionScaling) {
+                dynamicResolutionEnd(sScene.resolution, sOptions.headless ? offscreen.id : 0);
+            }
+
+            if (sScene.screenshotRequested) {
+                captureRequest(sScene.capture, "screenshot.png");
+                sScene.screenshotRequested = false;
+            }
+            captureRecordFrame(sScene.capture);
+            captureUpdate(sScene.capture);
+
+            PROFILE_CPU("swap");
+            if (sOptions.headless) {
+                frameFencesAdvance(frameFences);
+            } else {
+                glfwSwapBuffers(window);
+            }
+        }
+        frameLimiterWait(limiter);
+        PROFILER_END_FRAME();
+        numFrames++;
+
+        /* heap allocations of the frame, call sites are recorded once the warm-up frames are over */
+        if (ALLOC_TRACKING_AVAILABLE) {
+            sScene.allocFrame = allocTrackingEndFrame();
+            if (numFrames > sOptions.allocWarmup) {
+                sScene.allocSteady.allocations += sScene.allocFrame.allocations;
+                sScene.allocSteady.frees += sScene.allocFrame.frees;
+                sScene.allocSteady.bytes += sScene.allocFrame.bytes;
+                sScene.allocSteadyFrames++;
+                sScene.allocFramesAllocating += sScene.allocFrame.allocations > 0 ? 1 : 0;
+            }
+            if (numFrames == sOptions.allocWarmup) {
+                allocTrackingRecordSites(true);
+            }
+        }
+
+        /* full period of the loop, from event processing to waiting for vsync or the limiter */
+        double timeFrameEnd = glfwGetTime();
+        frameHistogramAdd(sScene.frameTimes, 1000.0 * (timeFrameEnd - timeFrameStart));
         timeStamp = timeStampNew;
 
-        sceneDraw();
-        glfwSwapBuffers(window);
+        if (sOptions.statsInterval > 0.0 && timeFrameEnd - timeStats >= sOptions.statsInterval) {
+            std::cout << "[Frame] " << frameHistogramSummary(sScene.frameTimes) << std::endl;
+            std::cout << "[Update] " << frameHistogramSummary(sScene.updateTimes) << std::endl;
+            if (ALLOC_TRACKING_AVAILABLE) {
+                std::cout << "[Alloc] last frame: " << sScene.allocFrame.allocations << " allocations, " << sScene.allocFrame.bytes << " B" << std::endl;
+            }
+            timeStats = timeFrameEnd;
+        }
     }
 
-    shaderDelete(sScene.shaderColor);
+    PROFILER_STOP();
+    double timeTotal = glfwGetTime() - timeStart;
+    if (sOptions.headless || sOptions.maxFrames > 0 || sScene.inputReplaying) {
+        std::cout << "[Frames] " << numFrames << " frames in " << timeTotal << " s, avg "
+                  << (numFrames ? 1000.0 * timeTotal / numFrames : 0.0) << " ms" << std::endl;
+    }
+    std::cout << "[Frame] " << frameHistogramSummary(sScene.frameTimes) << std::endl;
+    std::cout << "[Update] " << frameHistogramSummary(sScene.updateTimes) << std::endl;
+    FrameArenaStats arena = frameArenaStats(sScene.frameArena);
+    std::cout << "[FrameArena] high-water " << arena.highWater / 1024 << " KiB over all sub-arenas (" << arena.capacity / 1024
+              << " KiB reserved, grown " << arena.grows << " times)" << std::endl;
+    if (ALLOC_TRACKING_AVAILABLE && sScene.allocSteadyFrames > 0) {
+        allocTrackingRecordSites(false);
+        const AllocFrameStats &steady = sScene.allocSteady;
+        std::cout << "[Alloc] " << sScene.allocSteadyFrames << " frames after " << sOptions.allocWarmup << " warm-up frames: "
+                  << sScene.allocFramesAllocating << " allocating, " << static_cast<double>(steady.allocations) / sScene.allocSteadyFrames
+                  << " allocations (" << static_cast<double>(steady.bytes) / sScene.allocSteadyFrames << " B) and "
+                  << static_cast<double>(steady.frees) / sScene.allocSteadyFrames << " frees per frame" << std::endl;
+        std::cout << allocTrackingReport(20);
+    }
+
+    /* input changes after the last step (e.g. releasing the keys) only matter for the camera, applied for completeness */
+    if (sScene.inputReplaying) {
+        InputEvent event;
+        while (inputLogNext(sScene.inputLog, static_cast<std::uint32_t>(sScene.simSteps), event)) {
+            inputApply(event);
+        }
+        std::cout << "[Replay] " << sScene.simSteps << " of " << sScene.inputLog.numSteps << " steps, "
+                  << sScene.inputLog.events.size() << " events in " << timeTotal << " s ("
+                  << (timeTotal > 0.0 ? sScene.simSteps / timeTotal : 0.0) << " steps/s"
+                  << (sOptions.noRender ? ", not rendered" : "") << ")" << std::endl;
+    }
+    if (sScene.inputRecording) {
+        sScene.inputLog.numSteps = static_cast<std::uint32_t>(sScene.simSteps);
+        if (inputLogSave(sScene.inputLog, sOptions.inputRecordPath)) {
+            std::cout << "[Input] Recorded " << sScene.inputLog.events.size() << " events over " << sScene.inputLog.numSteps
+                      << " steps to " << sOptions.inputRecordPath << std::endl;
+        }
+    }
+    if (sScene.inputReplaying || sScene.inputRecording) {
+        char hash[32];
+        std::snprintf(hash, sizeof(hash), "%016llx", static_cast<unsigned long long>(sceneStateHash()));
+        std::cout << "[State] hash " << hash << " after " << sScene.simSteps << " steps" << std::endl;
+    }
+
+    captureDelete(sScene.capture);
+    if (sScene.resolutionScaling) {
+        dynamicResolutionDelete(sScene.resolution);
+    }
+    if (sOptions.headless) {
+        frameFencesDelete(frameFences);
+        framebufferDelete(offscreen);
+    }
+    threadPoolDelete(sScene.workers);
+    frameArenaDelete(sScene.frameArena);
+    occlusionDelete(sScene.occlusion);
+    viewSetDelete(sScene.views);
+    shaderVariantsDelete(sScene.shaderColor);
     groundDelete(sScene.ground);
-    pickupDelete(sScene.pickup);
+    for (const auto &lod : sScene.lods) {
+        lodDelete(sScene.meshBuffer, lod);
+    }
+    meshDelete(sScene.meshBuffer, sScene.occlusionBox);
+    for (auto &pickup : sScene.pickups) {
+        pickupDelete(sScene.meshBuffer, pickup);
+    }
+
+    /* nothing is drawn anymore, so the frees are released right away; ranges still in use were never freed */
+    glFinish();
+    meshBufferEndFrame(sScene.meshBuffer);
+    if (rangeAllocatorStats(sScene.meshBuffer.vertexAllocator).allocations > 0) {
+        std::cerr << "[MeshBuffer] Leaked at exit: " << meshBufferSummary(sScene.meshBuffer) << std::endl;
+    }
+    meshBufferDelete(sScene.meshBuffer);
     windowDelete(window);
 
     return EXIT_SUCCESS;
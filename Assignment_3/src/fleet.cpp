@@ -0,0 +1,293 @@
+#include "fleet.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FLEET_USE_SSE 1
+#include <emmintrin.h>
+#endif
+
+namespace detail
+{
+    constexpr float fleetPi = 3.14159265358979323846f;
+    constexpr float fleetTwoPi = 2.0f * fleetPi;
+
+    /* The step is written once against the overloads below and instantiated for float (one vehicle, the remainder
+     * of a chunk) and for Lanes4 (four vehicles in one SSE register). Masks are bool for float and all-ones/zero
+     * lanes for Lanes4. */
+    template <typename T> T lanesLoad(const float *p);
+    template <typename T> T lanesSet(float value);
+
+    template <> inline float lanesLoad<float>(const float *p) { return *p; }
+    template <> inline float lanesSet<float>(float value) { return value; }
+    inline void lanesStore(float *p, float value) { *p = value; }
+    inline float lanesMin(float a, float b) { return std::min(a, b); }
+    inline float lanesMax(float a, float b) { return std::max(a, b); }
+    inline float lanesAbs(float a) { return std::fabs(a); }
+    inline float lanesSqrt(float a) { return std::sqrt(a); }
+    inline float lanesRound(float a) { return std::nearbyint(a); }  // round half to even, like cvtps2dq
+    inline bool lanesLess(float a, float b) { return a < b; }
+    inline float lanesSelect(bool mask, float a, float b) { return mask ? a : b; }
+
+#ifdef FLEET_USE_SSE
+    struct Lanes4 {
+        __m128 v;
+    };
+
+    inline Lanes4 operator+(Lanes4 a, Lanes4 b) { return {_mm_add_ps(a.v, b.v)}; }
+    inline Lanes4 operator-(Lanes4 a, Lanes4 b) { return {_mm_sub_ps(a.v, b.v)}; }
+    inline Lanes4 operator*(Lanes4 a, Lanes4 b) { return {_mm_mul_ps(a.v, b.v)}; }
+    inline Lanes4 operator/(Lanes4 a, Lanes4 b) { return {_mm_div_ps(a.v, b.v)}; }
+    inline Lanes4 operator-(Lanes4 a) { return {_mm_sub_ps(_mm_setzero_ps(), a.v)}; }
+
+    template <> inline Lanes4 lanesLoad<Lanes4>(const float *p) { return {_mm_loadu_ps(p)}; }
+    template <> inline Lanes4 lanesSet<Lanes4>(float value) { return {_mm_set1_ps(value)}; }
+    inline void lanesStore(float *p, Lanes4 value) { _mm_storeu_ps(p, value.v); }
+    inline Lanes4 lanesMin(Lanes4 a, Lanes4 b) { return {_mm_min_ps(a.v, b.v)}; }
+    inline Lanes4 lanesMax(Lanes4 a, Lanes4 b) { return {_mm_max_ps(a.v, b.v)}; }
+    inline Lanes4 lanesAbs(Lanes4 a) { return {_mm_andnot_ps(_mm_set1_ps(-0.0f), a.v)}; }
+    inline Lanes4 lanesSqrt(Lanes4 a) { return {_mm_sqrt_ps(a.v)}; }
+    inline Lanes4 lanesRound(Lanes4 a) { return {_mm_cvtepi32_ps(_mm_cvtps_epi32(a.v))}; }
+    inline Lanes4 lanesLess(Lanes4 a, Lanes4 b) { return {_mm_cmplt_ps(a.v, b.v)}; }
+    inline Lanes4 lanesSelect(Lanes4 mask, Lanes4 a, Lanes4 b)
+    {
+        return {_mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v))};
+    }
+#endif
+
+    /* angle wrapped to [-pi, pi] */
+    template <typename T>
+    T lanesWrap(T angle)
+    {
+        return angle - lanesRound(angle * lanesSet<T>(1.0f / fleetTwoPi)) * lanesSet<T>(fleetTwoPi);
+    }
+
+    /* branch-free sine: wrap to [-pi, pi], fold to [-pi/2, pi/2] with sin(x) = sin(pi - x) and evaluate the Taylor
+     * polynomial up to x^11 (error below 1e-7 on the folded range) */
+    template <typename T>
+    T lanesSin(T x)
+    {
+        x = lanesWrap(x);
+        T sign = lanesSelect(lanesLess(x, lanesSet<T>(0.0f)), lanesSet<T>(-1.0f), lanesSet<T>(1.0f));
+        T ax = lanesAbs(x);
+        T f = lanesMin(ax, lanesSet<T>(fleetPi) - ax);
+        T f2 = f * f;
+        T p = lanesSet<T>(-1.0f / 39916800.0f);
+        p = lanesSet<T>(1.0f / 362880.0f) + f2 * p;
+        p = lanesSet<T>(-1.0f / 5040.0f) + f2 * p;
+        p = lanesSet<T>(1.0f / 120.0f) + f2 * p;
+        p = lanesSet<T>(-1.0f / 6.0f) + f2 * p;
+        p = lanesSet<T>(1.0f) + f2 * p;
+        return sign * f * p;
+    }
+
+    template <typename T>
+    T lanesCos(T x)
+    {
+        return lanesSin(x + lanesSet<T>(0.5f * fleetPi));
+    }
+
+    /* ground height at (x, z), sum of the waves of the ground */
+    template <typename T>
+    T fleetHeight(const FleetParams &params, T x, T z)
+    {
+        T height = lanesSet<T>(0.0f);
+        for (std::size_t w = 0; w < params.waveAmplitude.size(); w++) {
+            T phase = lanesSet<T>(params.waveOmega[w]) * (lanesSet<T>(params.waveDirX[w]) * x + lanesSet<T>(params.waveDirZ[w]) * z);
+            height = height + lanesSet<T>(params.waveAmplitude[w]) * lanesSin(phase);
+        }
+        return height;
+    }
+
+    /* one step of the vehicles i .. i + lanes - 1, same rules as pickupUpdate + pickupAdjustToTerrain */
+    template <typename T>
+    void fleetStepLanes(Fleet &fleet, const FleetParams &params, float dt, unsigned int i)
+    {
+        const T zero = lanesSet<T>(0.0f);
+        T throttle = lanesLoad<T>(&fleet.throttle[i]);
+        T steerInput = lanesLoad<T>(&fleet.steerInput[i]);
+        T posX = lanesLoad<T>(&fleet.posX[i]);
+        T posZ = lanesLoad<T>(&fleet.posZ[i]);
+        T heading = lanesLoad<T>(&fleet.heading[i]);
+        T steering = lanesLoad<T>(&fleet.steering[i]);
+        T wheelAngle = lanesLoad<T>(&fleet.wheelAngle[i]);
+
+        lanesStore(&fleet.prevPosX[i], posX);
+        lanesStore(&fleet.prevPosY[i], lanesLoad<T>(&fleet.posY[i]));
+        lanesStore(&fleet.prevPosZ[i], posZ);
+        lanesStore(&fleet.prevHeading[i], heading);
+        lanesStore(&fleet.prevSteering[i], steering);
+        lanesStore(&fleet.prevWheelAngle[i], wheelAngle);
+        lanesStore(&fleet.prevNormalX[i], lanesLoad<T>(&fleet.normalX[i]));
+        lanesStore(&fleet.prevNormalY[i], lanesLoad<T>(&fleet.normalY[i]));
+        lanesStore(&fleet.prevNormalZ[i], lanesLoad<T>(&fleet.normalZ[i]));
+
+        /* steering follows the input up to the limit, without input it returns to the center */
+        T maxSteering = lanesSet<T>(params.maxSteering);
+        T steered = lanesMin(lanesMax(steering + steerInput * lanesSet<T>(params.steeringRate * dt), -maxSteering), maxSteering);
+        T centered = lanesSelect(lanesLess(lanesSet<T>(0.01f), lanesAbs(steering)), steering * lanesSet<T>(params.centering), zero);
+        steering = lanesSelect(lanesLess(zero, lanesAbs(steerInput)), steered, centered);
+
+        /* move along the heading, then turn in proportion to the distance. The vehicle frame of pickupAdjustToTerrain
+         * has z = cross(up, forward), i.e. it is mirrored: a turn that is positive in local space turns clockwise
+         * seen from above and the local wheel z points to -z of the unmirrored frame. */
+        T speed = throttle * lanesSet<T>(params.maxSpeed);
+        T distance = speed * lanesSet<T>(dt);
+        posX = posX + lanesCos(heading) * distance;
+        posZ = posZ - lanesSin(heading) * distance;
+        heading = lanesWrap(heading - distance * steerInput * lanesSet<T>(params.turnPerMeter));
+        wheelAngle = lanesWrap(wheelAngle + distance * lanesSet<T>(1.0f / params.wheelRadius));
+
+        /* terrain fit: wheel contact points on the ground, height from their average, the up vector from the
+         * triangle rear left, rear right, front center */
+        T s = lanesSin(heading);
+        T c = lanesCos(heading);
+        T wheelX[4], wheelY[4], wheelZ[4];
+        for (int k = 0; k < 4; k++) {
+            T localX = lanesSet<T>(params.wheelX[k]);
+            T localZ = lanesSet<T>(params.wheelZ[k]);
+            wheelX[k] = posX + c * localX - s * localZ;
+            wheelZ[k] = posZ - s * localX - c * localZ;
+            wheelY[k] = fleetHeight(params, wheelX[k], wheelZ[k]);
+        }
+        T posY = (wheelY[WheelFL] + wheelY[WheelFR] + wheelY[WheelRL] + wheelY[WheelRR]) * lanesSet<T>(0.25f);
+
+        T half = lanesSet<T>(0.5f);
+        T abX = wheelX[WheelRR] - wheelX[WheelRL];
+        T abY = wheelY[WheelRR] - wheelY[WheelRL];
+        T abZ = wheelZ[WheelRR] - wheelZ[WheelRL];
+        T acX = (wheelX[WheelFL] + wheelX[WheelFR]) * half - wheelX[WheelRL];
+        T acY = (wheelY[WheelFL] + wheelY[WheelFR]) * half - wheelY[WheelRL];
+        T acZ = (wheelZ[WheelFL] + wheelZ[WheelFR]) * half - wheelZ[WheelRL];
+
+        T normalX = acY * abZ - acZ * abY;
+        T normalY = acZ * abX - acX * abZ;
+        T normalZ = acX * abY - acY * abX;
+        T length = lanesMax(lanesSqrt(normalX * normalX + normalY * normalY + normalZ * normalZ), lanesSet<T>(1e-12f));
+        T scale = lanesSelect(lanesLess(normalY, zero), lanesSet<T>(-1.0f), lanesSet<T>(1.0f)) / length;
+
+        lanesStore(&fleet.posX[i], posX);
+        lanesStore(&fleet.posY[i], posY);
+        lanesStore(&fleet.posZ[i], posZ);
+        lanesStore(&fleet.heading[i], heading);
+        lanesStore(&fleet.steering[i], steering);
+        lanesStore(&fleet.wheelAngle[i], wheelAngle);
+        lanesStore(&fleet.speed[i], speed);
+        lanesStore(&fleet.normalX[i], normalX * scale);
+        lanesStore(&fleet.normalY[i], normalY * scale);
+        lanesStore(&fleet.normalZ[i], normalZ * scale);
+    }
+
+    void fleetStepRange(Fleet &fleet, const FleetParams &params, float dt, unsigned int begin, unsigned int end)
+    {
+        unsigned int i = begin;
+#ifdef FLEET_USE_SSE
+        for (; i + 4 <= end; i += 4) {
+            fleetStepLanes<Lanes4>(fleet, params, dt, i);
+        }
+#endif
+        for (; i < end; i++) {
+            fleetStepLanes<float>(fleet, params, dt, i);
+        }
+    }
+}
+
+FleetParams fleetParamsCreate(const Pickup &pickup, const Ground &ground, float maxSpeed, float maxSteering, float turningAnglePerMeterDeg)
+{
+    FleetParams params;
+    params.maxSpeed = maxSpeed;
+    params.maxSteering = maxSteering;
+    params.steeringRate = 4.0f * maxSteering;
+    params.centering = 0.8f;
+    params.turnPerMeter = to_radians(turningAnglePerMeterDeg);
+    params.wheelRadius = pickup.frontWheelRadius;
+    for (int k = 0; k < 4; k++) {
+        params.wheelX[k] = pickup.wheelPos[k].x;
+        params.wheelZ[k] = pickup.wheelPos[k].z;
+    }
+
+    for (const auto &wave : ground.waveParamsVec) {
+        params.waveAmplitude.push_back(wave.amplitude);
+        params.waveOmega.push_back(wave.omega);
+        params.waveDirX.push_back(wave.direction.x);
+        params.waveDirZ.push_back(wave.direction.y);
+    }
+    return params;
+}
+
+unsigned int fleetAdd(Fleet &fleet, float x, float z, float heading)
+{
+    fleet.throttle.push_back(0.0f);
+    fleet.steerInput.push_back(0.0f);
+    fleet.posX.push_back(x);
+    fleet.posY.push_back(0.0f);
+    fleet.posZ.push_back(z);
+    fleet.heading.push_back(detail::lanesWrap(heading));
+    fleet.steering.push_back(0.0f);
+    fleet.wheelAngle.push_back(0.0f);
+    fleet.speed.push_back(0.0f);
+    fleet.normalX.push_back(0.0f);
+    fleet.normalY.push_back(1.0f);
+    fleet.normalZ.push_back(0.0f);
+    fleet.prevPosX.push_back(x);
+    fleet.prevPosY.push_back(0.0f);
+    fleet.prevPosZ.push_back(z);
+    fleet.prevHeading.push_back(fleet.heading.back());
+    fleet.prevSteering.push_back(0.0f);
+    fleet.prevWheelAngle.push_back(0.0f);
+    fleet.prevNormalX.push_back(0.0f);
+    fleet.prevNormalY.push_back(1.0f);
+    fleet.prevNormalZ.push_back(0.0f);
+    return fleetSize(fleet) - 1;
+}
+
+unsigned int fleetSize(const Fleet &fleet)
+{
+    return static_cast<unsigned int>(fleet.posX.size());
+}
+
+void fleetStep(Fleet &fleet, const FleetParams &params, float dt, ThreadPool *pool)
+{
+    unsigned int count = fleetSize(fleet);
+    if (!pool) {
+        detail::fleetStepRange(fleet, params, dt, 0, count);
+        return;
+    }
+
+    /* chunks in groups of four, so only the last chunk has a scalar remainder */
+    unsigned int groups = (count + 3) / 4;
+    threadPoolParallelFor(*pool, groups, [&fleet, &params, dt, count](unsigned int begin, unsigned int end, unsigned int) {
+        detail::fleetStepRange(fleet, params, dt, 4 * begin, std::min(4 * end, count));
+    });
+}
+
+PickupState fleetGetState(const Fleet &fleet, unsigned int index, float alpha)
+{
+    Vector3D position(
+        fleet.prevPosX[index] + alpha * (fleet.posX[index] - fleet.prevPosX[index]),
+        fleet.prevPosY[index] + alpha * (fleet.posY[index] - fleet.prevPosY[index]),
+        fleet.prevPosZ[index] + alpha * (fleet.posZ[index] - fleet.prevPosZ[index]));
+    float turn = detail::lanesWrap(fleet.heading[index] - fleet.prevHeading[index]);
+    float heading = fleet.prevHeading[index] + alpha * turn;
+
+    /* same frame as pickupAdjustToTerrain: x = forward, y = terrain normal, z = right */
+    Vector3D prevNormal(fleet.prevNormalX[index], fleet.prevNormalY[index], fleet.prevNormalZ[index]);
+    Vector3D normal(fleet.normalX[index], fleet.normalY[index], fleet.normalZ[index]);
+    normal = normalize(prevNormal + alpha * (normal - prevNormal));
+    Vector3D flatForward(std::cos(heading), 0.0f, -std::sin(heading));
+    Vector3D right = normalize(cross(normal, flatForward));
+    Vector3D forward = cross(right, normal);
+
+    PickupState state;
+    state.vehicleTransform = Matrix4D::identity();
+    state.vehicleTransform(0, 0) = forward.x; state.vehicleTransform(0, 1) = normal.x; state.vehicleTransform(0, 2) = right.x;
+    state.vehicleTransform(1, 0) = forward.y; state.vehicleTransform(1, 1) = normal.y; state.vehicleTransform(1, 2) = right.y;
+    state.vehicleTransform(2, 0) = forward.z; state.vehicleTransform(2, 1) = normal.z; state.vehicleTransform(2, 2) = right.z;
+    state.vehicleTransform = Matrix4D::translation(position) * state.vehicleTransform;
+    /* the rolling angle wraps at ±pi, blend over the shorter way like pickupInterpolate */
+    float roll = detail::lanesWrap(fleet.wheelAngle[index] - fleet.prevWheelAngle[index]);
+    state.wheelRotationAngle = detail::lanesWrap(fleet.prevWheelAngle[index] + alpha * roll);
+    state.wheelSteeringAngle = fleet.prevSteering[index] + alpha * (fleet.steering[index] - fleet.prevSteering[index]);
+    return state;
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <vector>
+
+#include "ground.h"
+#include "mygl/threadpool.h"
+#include "pickup.h"
+
+/* Simulation of many vehicles in structure-of-arrays form: only the state a step reads and writes, one array per
+ * quantity, so a step streams through memory and processes four vehicles per SSE instruction. Meshes and scene
+ * graph nodes stay in the Pickup structs of the renderer. */
+struct Fleet {
+    /* inputs in [-1, 1] */
+    std::vector<float> throttle;
+    std::vector<float> steerInput;
+
+    /* hot state */
+    std::vector<float> posX, posY, posZ;
+    std::vector<float> heading;         // rotation around +y, 0 drives along +x
+    std::vector<float> steering;        // steering angle of the front wheels
+    std::vector<float> wheelAngle;      // rolling angle of the wheels
+    std::vector<float> speed;           // signed, along the heading
+
+    /* terrain fit, up vector of the vehicle */
+    std::vector<float> normalX, normalY, normalZ;
+
+    /* state before the last step, rendering interpolates from it */
+    std::vector<float> prevPosX, prevPosY, prevPosZ, prevHeading;
+    std::vector<float> prevSteering, prevWheelAngle;
+    std::vector<float> prevNormalX, prevNormalY, prevNormalZ;
+};
+
+/* parameters shared by all vehicles (taken from the pickup geometry and the driving parameters of the scene) */
+struct FleetParams {
+    float maxSpeed = 5.0f;
+    float maxSteering = 0.5f;           // rad
+    float steeringRate = 2.0f;          // rad per second while a steering input is held
+    float centering = 0.8f;             // steering is multiplied with this per step without input
+    float turnPerMeter = 0.1f;          // rad of heading change per meter at full steering
+    float wheelRadius = 0.7f;
+    float wheelX[4] = {};               // local wheel positions (index: eWheel)
+    float wheelZ[4] = {};
+
+    /* ground waves as arrays, so they can be broadcast into SIMD registers */
+    std::vector<float> waveAmplitude, waveOmega, waveDirX, waveDirZ;
+};
+
+/**
+ * @brief Parameters for vehicles shaped like the given pickup on the given ground.
+ *
+ * @param pickup Pickup whose wheel positions and radius are used.
+ * @param ground Ground whose height field the vehicles follow.
+ * @param maxSpeed Speed at full throttle (m/s).
+ * @param maxSteering Largest steering angle (rad).
+ * @param turningAnglePerMeterDeg Heading change per meter at full steering (degrees, see calculateTurningAnglePerMeter).
+ *
+ * @return Fleet parameters.
+ */
+FleetParams fleetParamsCreate(const Pickup &pickup, const Ground &ground, float maxSpeed, float maxSteering, float turningAnglePerMeterDeg);
+
+/**
+ * @brief Adds a vehicle standing still at the given position.
+ *
+ * @param fleet Fleet.
+ * @param x, z Position on the ground plane.
+ * @param heading Rotation around +y.
+ *
+ * @return Index of the vehicle.
+ */
+unsigned int fleetAdd(Fleet &fleet, float x, float z, float heading);
+
+/**
+ * @brief Number of vehicles.
+ */
+unsigned int fleetSize(const Fleet &fleet);
+
+/**
+ * @brief Advances all vehicles by one step: steering, integration of heading/position/wheel angle and the fit of the
+ * four wheels to the terrain. Runs four vehicles per iteration with SSE and spreads the vehicles over the pool.
+ *
+ * @param fleet Fleet.
+ * @param params Fleet parameters.
+ * @param dt Step length in seconds.
+ * @param pool Worker threads, nullptr runs on the calling thread.
+ */
+void fleetStep(Fleet &fleet, const FleetParams &params, float dt, ThreadPool *pool = nullptr);
+
+/**
+ * @brief State of a vehicle for rendering, interpolated between the previous and the current step.
+ *
+ * @param fleet Fleet.
+ * @param index Vehicle index.
+ * @param alpha Blend factor, 0 = previous step, 1 = current step.
+ *
+ * @return Vehicle transform (x = forward, y = terrain normal) and wheel angles.
+ */
+PickupState fleetGetState(const Fleet &fleet, unsigned int index, float alpha = 1.0f);
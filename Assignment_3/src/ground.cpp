@@ -49,7 +49,7 @@ Ground groundCreate(const Vector3D &color) {
         float t = (heights[i] - minHeight) / (maxHeight - minHeight);
         ground.vertices[i] = {pos, computeColor(lowColor, highColor, t)};
     }
-    ground.mesh = meshCreate(ground.vertices, grid::indices, GL_DYNAMIC_DRAW, GL_STATIC_DRAW);
+    ground.mesh = meshCreate(ground.vertices, std::vector<unsigned int>(grid::indices.begin(), grid::indices.end()), GL_DYNAMIC_DRAW, GL_STATIC_DRAW);
 
     return ground;
 }
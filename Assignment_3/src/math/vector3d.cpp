@@ -7,8 +7,6 @@
 #include <cmath>
 #include <sstream>
 
-Vector3D::Vector3D(float x, float y, float z) : x(x), y(y), z(z) {}
-
 Vector3D::Vector3D(const Vector4D &v) : x(v.x), y(v.y), z(v.z) {}
 
 Vector3D Vector3D::operator-() const { 
@@ -7,7 +7,7 @@ struct Vector4D;
 struct Vector3D {
     float x, y, z;
 
-    Vector3D(float x = 0, float y = 0, float z = 0);
+    constexpr Vector3D(float x = 0, float y = 0, float z = 0) : x(x), y(y), z(z) {}
     Vector3D(const Vector4D &v);
 
     Vector3D &operator*=(float s);
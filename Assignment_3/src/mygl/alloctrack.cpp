@@ -0,0 +1,293 @@
+#include "alloctrack.h"
+
+#ifdef ENABLE_ALLOC_TRACKING
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <sstream>
+#include <vector>
+
+#if defined(__GLIBC__) || defined(__APPLE__)
+#define ALLOC_TRACKING_BACKTRACE 1
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#endif
+
+namespace detail
+{
+    constexpr std::size_t allocHeader = 16;         // size and offset of the block, keeps 16 byte alignment
+    constexpr unsigned int allocSiteCapacity = 4096;
+    constexpr int allocStackDepth = 10;
+
+    /* call site table in static storage (recording must not allocate), open addressing on the stack hash */
+    struct AllocSite
+    {
+        std::atomic<std::uint64_t> key{0};  // 0 = empty
+        void *stack[allocStackDepth];
+        int depth;
+        const char *scope;
+        std::atomic<unsigned long long> count{0};
+        std::atomic<unsigned long long> bytes{0};
+    };
+
+    AllocSite allocSites[allocSiteCapacity];
+    std::atomic<unsigned int> allocSitesDropped{0};
+    std::atomic<bool> allocRecordSites{false};
+
+    std::atomic<unsigned long long> allocCount{0};
+    std::atomic<unsigned long long> allocFrees{0};
+    std::atomic<unsigned long long> allocBytes{0};
+
+    thread_local const char *allocScope = nullptr;
+    thread_local bool allocInside = false;          // allocations of the tracker itself (backtrace) aren't recorded
+
+    void recordSite(std::size_t size)
+    {
+#ifdef ALLOC_TRACKING_BACKTRACE
+        /* starts with the tracker itself, the frames are filtered when the report resolves them (inlining makes
+         * the number of own frames unknown) */
+        void *frames[allocStackDepth];
+        int depth = backtrace(frames, allocStackDepth);
+#else
+        void *frames[1] = {nullptr};
+        int depth = 0;
+#endif
+
+        std::uint64_t key = 1469598103934665603ull;
+        for (int i = 0; i < depth; i++) {
+            key = (key ^ reinterpret_cast<std::uintptr_t>(frames[i])) * 1099511628211ull;
+        }
+        key = (key ^ reinterpret_cast<std::uintptr_t>(allocScope)) * 1099511628211ull;
+        key = key ? key : 1;
+
+        for (unsigned int probe = 0; probe < allocSiteCapacity; probe++) {
+            AllocSite &site = allocSites[(key + probe) % allocSiteCapacity];
+            std::uint64_t current = site.key.load(std::memory_order_acquire);
+            if(current == 0)
+            {
+                if(site.key.compare_exchange_strong(current, key))
+                {
+                    std::copy(frames, frames + depth, site.stack);
+                    site.depth = depth;
+                    site.scope = allocScope;
+                    current = key;
+                }
+            }
+            if(current == key)
+            {
+                site.count.fetch_add(1, std::memory_order_relaxed);
+                site.bytes.fetch_add(size, std::memory_order_relaxed);
+                return;
+            }
+        }
+        allocSitesDropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /* [raw .. header | size, offset | block], the block aligned to `alignment` */
+    void *allocate(std::size_t size, std::size_t alignment, bool nothrow)
+    {
+        alignment = std::max(alignment, allocHeader);
+        void *raw;
+        while (!(raw = std::malloc(size + allocHeader + alignment))) {
+            std::new_handler handler = std::get_new_handler();
+            if(!handler)
+            {
+                if(nothrow)
+                {
+                    return nullptr;
+                }
+                throw std::bad_alloc();
+            }
+            handler();
+        }
+
+        std::uintptr_t block = (reinterpret_cast<std::uintptr_t>(raw) + allocHeader + alignment - 1) / alignment * alignment;
+        std::size_t *header = reinterpret_cast<std::size_t *>(block - allocHeader);
+        header[0] = size;
+        header[1] = block - reinterpret_cast<std::uintptr_t>(raw);
+
+        allocCount.fetch_add(1, std::memory_order_relaxed);
+        allocBytes.fetch_add(size, std::memory_order_relaxed);
+        if(allocRecordSites.load(std::memory_order_relaxed) && !allocInside)
+        {
+            allocInside = true;
+            recordSite(size);
+            allocInside = false;
+        }
+        return reinterpret_cast<void *>(block);
+    }
+
+    void release(void *block)
+    {
+        if(!block)
+        {
+            return;
+        }
+        std::size_t *header = reinterpret_cast<std::size_t *>(reinterpret_cast<std::uintptr_t>(block) - allocHeader);
+        allocFrees.fetch_add(1, std::memory_order_relaxed);
+        std::free(reinterpret_cast<void *>(reinterpret_cast<std::uintptr_t>(block) - header[1]));
+    }
+
+    /* name of the function containing an address, "" if it can't be resolved */
+    std::string symbolName(void *address)
+    {
+#ifdef ALLOC_TRACKING_BACKTRACE
+        Dl_info info;
+        if(dladdr(address, &info) && info.dli_sname)
+        {
+            int status = 0;
+            char *demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+            std::string name = status == 0 && demangled ? demangled : info.dli_sname;
+            std::free(demangled);
+            return name;
+        }
+#endif
+        (void) address;
+        return "";
+    }
+
+    /* frames of the allocator and the standard library say nothing about who allocates */
+    bool internalFrame(const std::string &name)
+    {
+        std::string head = name.substr(0, name.find('('));
+        return head.find("operator new") != std::string::npos || head.find("std::") != std::string::npos
+               || head.find("__gnu_cxx::") != std::string::npos || head.find("detail::allocate") != std::string::npos
+               || head.find("detail::recordSite") != std::string::npos;
+    }
+}
+
+AllocScope::AllocScope(const char *name) : previous(detail::allocScope)
+{
+    detail::allocScope = name;
+}
+
+AllocScope::~AllocScope()
+{
+    detail::allocScope = previous;
+}
+
+AllocFrameStats allocTrackingEndFrame()
+{
+    AllocFrameStats stats;
+    stats.allocations = detail::allocCount.exchange(0);
+    stats.frees = detail::allocFrees.exchange(0);
+    stats.bytes = detail::allocBytes.exchange(0);
+    return stats;
+}
+
+void allocTrackingRecordSites(bool enable)
+{
+    detail::allocRecordSites = enable;
+}
+
+std::string allocTrackingReport(unsigned int maxSites)
+{
+    bool recording = detail::allocRecordSites.exchange(false);
+
+    std::vector<const detail::AllocSite *> sites;
+    for (const auto &site : detail::allocSites) {
+        if(site.key.load() != 0)
+        {
+            sites.push_back(&site);
+        }
+    }
+    std::sort(sites.begin(), sites.end(), [](const detail::AllocSite *a, const detail::AllocSite *b) { return a->count > b->count; });
+
+    std::ostringstream report;
+    if(!sites.empty())
+    {
+        /* totals per scope first, then the call sites */
+        std::vector<std::pair<std::string, unsigned long long>> scopes;
+        for (const auto *site : sites) {
+            std::string scope = site->scope ? site->scope : "(no scope)";
+            auto it = std::find_if(scopes.begin(), scopes.end(), [&scope](const auto &s) { return s.first == scope; });
+            if(it == scopes.end())
+            {
+                scopes.emplace_back(scope, 0);
+                it = scopes.end() - 1;
+            }
+            it->second += site->count;
+        }
+        std::sort(scopes.begin(), scopes.end(), [](const auto &a, const auto &b) { return a.second > b.second; });
+        for (const auto &scope : scopes) {
+            report << "  scope " << scope.first << ": " << scope.second << " allocations\n";
+        }
+
+        for (std::size_t i = 0; i < sites.size() && i < maxSites; i++) {
+            const detail::AllocSite &site = *sites[i];
+            report << "  " << site.count << "x " << site.bytes << " B [" << (site.scope ? site.scope : "-") << "] ";
+
+            /* the first two frames outside of the allocator and the standard library */
+            int shown = 0;
+            for (int f = 0; f < site.depth && shown < 2; f++) {
+                std::string name = detail::symbolName(site.stack[f]);
+                if(!name.empty() && detail::internalFrame(name))
+                {
+                    continue;
+                }
+                if(name.empty())
+                {
+                    std::ostringstream address;
+                    address << site.stack[f];
+                    name = address.str();
+                }
+                report << (shown ? " <- " : "") << name;
+                shown++;
+            }
+            report << "\n";
+        }
+        if(detail::allocSitesDropped > 0)
+        {
+            report << "  (" << detail::allocSitesDropped << " allocations not recorded, call site table full)\n";
+        }
+    }
+
+    detail::allocRecordSites = recording;
+    return report.str();
+}
+
+/* replaced global allocation functions, all variants end up in detail::allocate / detail::release */
+void *operator new(std::size_t size) { return detail::allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__, false); }
+void *operator new[](std::size_t size) { return detail::allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__, false); }
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept { return detail::allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__, true); }
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept { return detail::allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__, true); }
+void *operator new(std::size_t size, std::align_val_t alignment) { return detail::allocate(size, static_cast<std::size_t>(alignment), false); }
+void *operator new[](std::size_t size, std::align_val_t alignment) { return detail::allocate(size, static_cast<std::size_t>(alignment), false); }
+void *operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept { return detail::allocate(size, static_cast<std::size_t>(alignment), true); }
+void *operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept { return detail::allocate(size, static_cast<std::size_t>(alignment), true); }
+
+void operator delete(void *block) noexcept { detail::release(block); }
+void operator delete[](void *block) noexcept { detail::release(block); }
+void operator delete(void *block, std::size_t) noexcept { detail::release(block); }
+void operator delete[](void *block, std::size_t) noexcept { detail::release(block); }
+void operator delete(void *block, const std::nothrow_t &) noexcept { detail::release(block); }
+void operator delete[](void *block, const std::nothrow_t &) noexcept { detail::release(block); }
+void operator delete(void *block, std::align_val_t) noexcept { detail::release(block); }
+void operator delete[](void *block, std::align_val_t) noexcept { detail::release(block); }
+void operator delete(void *block, std::size_t, std::align_val_t) noexcept { detail::release(block); }
+void operator delete[](void *block, std::size_t, std::align_val_t) noexcept { detail::release(block); }
+void operator delete(void *block, std::align_val_t, const std::nothrow_t &) noexcept { detail::release(block); }
+void operator delete[](void *block, std::align_val_t, const std::nothrow_t &) noexcept { detail::release(block); }
+
+#else
+
+AllocFrameStats allocTrackingEndFrame()
+{
+    return AllocFrameStats();
+}
+
+void allocTrackingRecordSites(bool)
+{
+}
+
+std::string allocTrackingReport(unsigned int)
+{
+    return "";
+}
+
+#endif
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <string>
+
+/*
+ * Heap allocation tracking through replaced global operator new/delete.
+ *
+ * Only built if ENABLE_ALLOC_TRACKING is defined (CMake option ALLOC_TRACKING), otherwise the functions do nothing and
+ * ALLOC_SCOPE expands to nothing. Every allocation and free is counted per frame. While call site recording is on
+ * (e.g. after some warm-up frames, to find what still allocates in the steady state), each allocation also records
+ * its call stack and the innermost named scope of the thread:
+ *
+ *   {
+ *       ALLOC_SCOPE("sceneUpdate");     // PROFILE_CPU(...) opens one as well
+ *       ...
+ *   }
+ *   AllocFrameStats frame = allocTrackingEndFrame();
+ *   std::cout << allocTrackingReport(20);
+ *
+ * Call sites are resolved with dladdr, i.e. the executable has to export its symbols (-rdynamic, see CMakeLists.txt).
+ * Scope names have to be string literals.
+ */
+
+struct AllocFrameStats
+{
+    unsigned long long allocations = 0;
+    unsigned long long frees = 0;
+    unsigned long long bytes = 0;   // allocated bytes
+};
+
+/**
+ * @brief Counters since the last call, i.e. of the frame that just ended, and starts counting the next frame.
+ *
+ * @return Allocations, frees and allocated bytes (all zero if tracking isn't built).
+ */
+AllocFrameStats allocTrackingEndFrame();
+
+/**
+ * @brief Starts or stops recording the call stack and scope of every allocation (slow, for the steady state only).
+ *
+ * @param enable True to record call sites.
+ */
+void allocTrackingRecordSites(bool enable);
+
+/**
+ * @brief Recorded call sites with the most allocations, grouped per scope, one per line.
+ *
+ * @param maxSites Number of call sites listed.
+ *
+ * @return Report text, empty if nothing was recorded.
+ */
+std::string allocTrackingReport(unsigned int maxSites);
+
+#ifdef ENABLE_ALLOC_TRACKING
+
+struct AllocScope
+{
+    const char *previous;
+
+    explicit AllocScope(const char *name);
+    ~AllocScope();
+};
+
+#define ALLOC_CONCAT_(a, b) a##b
+#define ALLOC_CONCAT(a, b) ALLOC_CONCAT_(a, b)
+#define ALLOC_SCOPE(name) AllocScope ALLOC_CONCAT(allocScope, __LINE__)(name)
+#define ALLOC_TRACKING_AVAILABLE 1
+
+#else
+
+#define ALLOC_SCOPE(name) ((void)0)
+#define ALLOC_TRACKING_AVAILABLE 0
+
+#endif
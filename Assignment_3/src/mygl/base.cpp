@@ -47,6 +47,7 @@ void screenshotToPNG(const std::string &filepath)
 
     stbi_flip_vertically_on_write(true);
     stbi_write_png(filepath.c_str(), width, height, 4, data.data(), width * 4);
+    stbi_flip_vertically_on_write(false);
 }
 
 void glfw_error_callback(int error, const char* description)
@@ -54,7 +55,7 @@ void glfw_error_callback(int error, const char* description)
     std::cerr << "GLFW Error: " <<  description << std::endl;
 }
 
-GLFWwindow* windowCreate(const std::string& title, unsigned int width = 1280, unsigned int height = 720)
+GLFWwindow* windowCreate(const std::string& title, unsigned int width, unsigned int height, bool headless)
 {
     /*-------------- init glfw ----------------*/
     if(!glfwInit())
@@ -77,6 +78,15 @@ GLFWwindow* windowCreate(const std::string& title, unsigned int width = 1280, un
     glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
 #endif
 
+    /* headless: the window is never shown, frames are rendered into a framebuffer object */
+    if(headless)
+    {
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+#ifdef HEADLESS_OSMESA
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+#endif
+    }
+
     /* create window and its opengl context */
     GLFWwindow* window = glfwCreateWindow(width, height, title.c_str(), nullptr, nullptr);
     if(window == nullptr)
@@ -88,7 +98,7 @@ GLFWwindow* windowCreate(const std::string& title, unsigned int width = 1280, un
 
     /* make context the current one */
     glfwMakeContextCurrent(window);
-    glfwSwapInterval(1);
+    glfwSwapInterval(headless ? 0 : 1);
 
     /*-------------- init glad ----------------*/
     /* load opengl extensions */
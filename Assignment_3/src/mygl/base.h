@@ -24,10 +24,12 @@
  * @param title Window title
  * @param width Window width
  * @param height Window height
+ * @param headless Create a hidden window without vsync, rendering has to go to an offscreen framebuffer. With GLFW
+ * built for OSMesa (HEADLESS_OSMESA) no display is needed at all.
  *
  * @return Initialized GLFW window.
  */
-GLFWwindow* windowCreate(const std::string &title, unsigned int width, unsigned int height);
+GLFWwindow* windowCreate(const std::string &title, unsigned int width, unsigned int height, bool headless = false);
 /**
  * @brief Delete GLFW window and OpenGL contexst. Has to be called for each window after it is not used anymore.
  *
@@ -36,7 +38,8 @@ GLFWwindow* windowCreate(const std::string &title, unsigned int width, unsigned
 void windowDelete(GLFWwindow* window);
 
 /**
- * @brief Save current viewport as PNG image.
+ * @brief Save current viewport as PNG image. Waits for the GPU and encodes on the calling thread, see captureRequest(...)
+ * in capture.h for the non-blocking version.
  *
  * @param filepath Path to output image.
  */
@@ -0,0 +1,450 @@
+#include "capture.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+#include <stb_image/stb_image_write.h>
+
+namespace detail
+{
+    void flipRows(CaptureImage &image)
+    {
+        std::size_t rowSize = static_cast<std::size_t>(image.width) * 4;
+        std::vector<unsigned char> row(rowSize);
+        for (int y = 0; y < image.height / 2; y++) {
+            unsigned char *top = image.pixels.data() + y * rowSize;
+            unsigned char *bottom = image.pixels.data() + (image.height - 1 - y) * rowSize;
+            std::memcpy(row.data(), top, rowSize);
+            std::memcpy(top, bottom, rowSize);
+            std::memcpy(bottom, row.data(), rowSize);
+        }
+    }
+
+    /* BT.601 limited range, planar Y, U, V without subsampling (C444) */
+    void toY4MFrame(const CaptureImage &image, std::vector<unsigned char> &frame)
+    {
+        static const char tag[] = "FRAME\n";
+        std::size_t planeSize = static_cast<std::size_t>(image.width) * image.height;
+        frame.resize(sizeof(tag) - 1 + 3 * planeSize);
+        std::memcpy(frame.data(), tag, sizeof(tag) - 1);
+
+        unsigned char *planeY = frame.data() + sizeof(tag) - 1;
+        unsigned char *planeU = planeY + planeSize;
+        unsigned char *planeV = planeU + planeSize;
+
+        for (int y = 0; y < image.height; y++) {
+            const unsigned char *src = image.pixels.data() + static_cast<std::size_t>(image.height - 1 - y) * image.width * 4;
+            std::size_t dst = static_cast<std::size_t>(y) * image.width;
+            for (int x = 0; x < image.width; x++, src += 4, dst++) {
+                int r = src[0], g = src[1], b = src[2];
+                planeY[dst] = static_cast<unsigned char>(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+                planeU[dst] = static_cast<unsigned char>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+                planeV[dst] = static_cast<unsigned char>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+            }
+        }
+    }
+
+    /* converts in parallel with the other encoders, then waits for its turn to append to the stream */
+    bool writeStreamFrame(CaptureEncoder &encoder, CaptureImage &image)
+    {
+        CaptureRecording &recording = encoder.recording;
+
+        std::vector<unsigned char> frame;
+        if(recording.format == CaptureFormatY4M)
+        {
+            toY4MFrame(image, frame);
+        }
+        else
+        {
+            flipRows(image);
+            frame = std::move(image.pixels);
+        }
+
+        std::unique_lock<std::mutex> lock(encoder.mutex);
+        encoder.streamTurn.wait(lock, [&] { return recording.nextSequence == image.sequence; });
+
+        /* the turn is ours until nextSequence advances, so the file can be written without holding the lock */
+        lock.unlock();
+        if(image.sequence == 0 && recording.format == CaptureFormatY4M)
+        {
+            recording.file << "YUV4MPEG2 W" << image.width << " H" << image.height << " F" << recording.fps
+                           << ":1 Ip A1:1 C444\n";
+        }
+        recording.file.write(reinterpret_cast<const char *>(frame.data()), frame.size());
+        bool ok = static_cast<bool>(recording.file);
+        lock.lock();
+
+        recording.nextSequence++;
+        encoder.streamTurn.notify_all();
+        return ok;
+    }
+
+    void encoderLoop(CaptureEncoder &encoder)
+    {
+        while (true) {
+            CaptureImage image;
+            {
+                std::unique_lock<std::mutex> lock(encoder.mutex);
+                encoder.wake.wait(lock, [&encoder] { return encoder.stop || !encoder.queue.empty(); });
+                if(encoder.queue.empty())
+                {
+                    return;
+                }
+                image = std::move(encoder.queue.front());
+                encoder.queue.pop_front();
+                encoder.busy++;
+            }
+
+            bool recorded = image.stream || image.sequence != ~0u;
+            bool ok;
+            if(image.stream)
+            {
+                ok = writeStreamFrame(encoder, image);
+            }
+            else
+            {
+                /* flip by hand, stbi_flip_vertically_on_write is a global flag shared with the render thread */
+                flipRows(image);
+                ok = stbi_write_png(image.path.c_str(), image.width, image.height, 4, image.pixels.data(), image.width * 4) != 0;
+            }
+            if(!ok)
+            {
+                std::cerr << "[Capture] Couldn't write " << (image.stream ? encoder.recording.path : image.path) << std::endl;
+            }
+
+            std::lock_guard<std::mutex> lock(encoder.mutex);
+            if(ok && recorded)
+            {
+                encoder.stats.written++;
+            }
+            encoder.busy--;
+            if(encoder.busy == 0 && encoder.queue.empty())
+            {
+                encoder.idle.notify_all();
+            }
+        }
+    }
+
+    void pushImage(CaptureEncoder &encoder, CaptureImage &&image)
+    {
+        {
+            std::lock_guard<std::mutex> lock(encoder.mutex);
+            encoder.queue.push_back(std::move(image));
+        }
+        encoder.wake.notify_one();
+    }
+
+    /* copies the pixels of a finished slot out of its buffer and queues them for the encoders */
+    void handOver(Capture &capture, CaptureSlot &slot)
+    {
+        glDeleteSync(slot.fence);
+        slot.fence = nullptr;
+
+        CaptureEncoder &encoder = *capture.encoder;
+        CaptureImage image;
+        image.width = slot.width;
+        image.height = slot.height;
+        image.path = std::move(slot.path);
+        image.sequence = ~0u;
+
+        /* decide before mapping, a dropped frame shouldn't cost the copy */
+        if(slot.recording)
+        {
+            std::lock_guard<std::mutex> lock(encoder.mutex);
+            CaptureRecording &recording = encoder.recording;
+            image.stream = recording.format != CaptureFormatPNG;
+
+            if(image.stream && recording.width == 0)
+            {
+                recording.width = slot.width;
+                recording.height = slot.height;
+            }
+            if(image.stream && (recording.width != slot.width || recording.height != slot.height))
+            {
+                encoder.stats.droppedSize++;
+                return;
+            }
+            if(encoder.queue.size() >= encoder.maxQueue)
+            {
+                encoder.stats.droppedQueue++;
+                return;
+            }
+
+            /* only the render thread queues, so the slot in the queue checked above stays free */
+            image.sequence = recording.numQueued++;
+            if(!image.stream)
+            {
+                char suffix[16];
+                std::snprintf(suffix, sizeof(suffix), "_%06u.png", image.sequence);
+                image.path = recording.path + suffix;
+            }
+        }
+
+        image.pixels.resize(static_cast<std::size_t>(slot.width) * slot.height * 4);
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+        void *mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, image.pixels.size(), GL_MAP_READ_BIT);
+        if(mapped)
+        {
+            std::memcpy(image.pixels.data(), mapped, image.pixels.size());
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        }
+        else
+        {
+            /* the sequence number is taken, so the stream still gets a (black) frame */
+            std::cerr << "[Capture] Couldn't map pixel buffer" << std::endl;
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        pushImage(encoder, std::move(image));
+    }
+
+    unsigned int tail(const Capture &capture)
+    {
+        unsigned int size = static_cast<unsigned int>(capture.slots.size());
+        return (capture.head + size - capture.numPending) % size;
+    }
+
+    void issueReadback(Capture &capture, const std::string &filepath, bool recording)
+    {
+        GLint viewport[4];
+        glGetIntegerv(GL_VIEWPORT, viewport);
+
+        CaptureSlot &slot = capture.slots[capture.head];
+        bool resized = slot.width != viewport[2] || slot.height != viewport[3];
+        slot.width = viewport[2];
+        slot.height = viewport[3];
+        slot.path = filepath;
+        slot.recording = recording;
+
+        /* the read back only gets queued on the GPU, glReadPixels returns right away when a pack buffer is bound */
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+        /* the slot's previous read back was mapped and handed over already, so its storage is reused as long as the
+         * size stays the same */
+        if(resized)
+        {
+            glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(slot.width) * slot.height * 4, nullptr, GL_STREAM_READ);
+        }
+        /* read whatever is drawn to, the back buffer or the color attachment of an offscreen framebuffer */
+        GLint framebuffer = 0;
+        glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &framebuffer);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+        glReadBuffer(framebuffer ? GL_COLOR_ATTACHMENT0 : GL_BACK);
+        glPixelStorei(GL_PACK_ALIGNMENT, 4);
+        glReadPixels(viewport[0], viewport[1], slot.width, slot.height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+        capture.head = (capture.head + 1) % capture.slots.size();
+        capture.numPending++;
+    }
+
+    /* blocks, only used when a recording stops or the capture is deleted */
+    void flush(Capture &capture)
+    {
+        while (capture.numPending > 0) {
+            CaptureSlot &slot = capture.slots[tail(capture)];
+            glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+            handOver(capture, slot);
+            capture.numPending--;
+        }
+
+        std::unique_lock<std::mutex> lock(capture.encoder->mutex);
+        capture.encoder->idle.wait(lock, [&capture] { return capture.encoder->busy == 0 && capture.encoder->queue.empty(); });
+    }
+}
+
+Capture captureCreate(unsigned int numSlots, unsigned int numEncoders, unsigned int maxQueue)
+{
+    Capture capture;
+    capture.slots.resize(numSlots > 0 ? numSlots : 1);
+    for (auto &slot : capture.slots) {
+        glGenBuffers(1, &slot.pbo);
+    }
+
+    if(numEncoders == 0)
+    {
+        numEncoders = std::max(1u, std::thread::hardware_concurrency() / 2);
+    }
+
+    capture.encoder = std::make_unique<CaptureEncoder>();
+    capture.encoder->maxQueue = std::max(1u, maxQueue);
+    for (unsigned int i = 0; i < numEncoders; i++) {
+        capture.encoderThreads.emplace_back(detail::encoderLoop, std::ref(*capture.encoder));
+    }
+    return capture;
+}
+
+bool captureRequest(Capture &capture, const std::string &filepath)
+{
+    if(capture.numPending == capture.slots.size())
+    {
+        std::cerr << "[Capture] All pixel buffers in flight, dropped " << filepath << std::endl;
+        return false;
+    }
+
+    detail::issueReadback(capture, filepath, false);
+    return true;
+}
+
+eCaptureFormat captureFormatFromPath(const std::string &path)
+{
+    auto endsWith = [&path](const std::string &suffix) {
+        return path.size() >= suffix.size() && path.compare(path.size() - suffix.size(), suffix.size(), suffix) == 0;
+    };
+
+    if(endsWith(".y4m"))
+    {
+        return CaptureFormatY4M;
+    }
+    if(endsWith(".rgba") || endsWith(".raw"))
+    {
+        return CaptureFormatRaw;
+    }
+    return CaptureFormatPNG;
+}
+
+bool captureStartRecording(Capture &capture, const std::string &path, eCaptureFormat format, unsigned int fps)
+{
+    if(captureIsRecording(capture))
+    {
+        captureStopRecording(capture);
+    }
+
+    /* all encoders are idle here, nobody else touches the recording */
+    CaptureEncoder &encoder = *capture.encoder;
+    CaptureRecording &recording = encoder.recording;
+    recording.format = format;
+    recording.path = path;
+    recording.fps = std::max(1u, fps);
+    recording.width = 0;
+    recording.height = 0;
+    recording.nextSequence = 0;
+    recording.numQueued = 0;
+
+    if(format != CaptureFormatPNG)
+    {
+        recording.file.open(path, std::ios::binary | std::ios::trunc);
+        if(!recording.file.is_open())
+        {
+            std::cerr << "[Capture] Couldn't open " << path << " for recording" << std::endl;
+            return false;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(encoder.mutex);
+    encoder.stats = CaptureStats();
+    recording.start = std::chrono::steady_clock::now();
+    recording.active = true;
+    return true;
+}
+
+void captureRecordFrame(Capture &capture)
+{
+    CaptureEncoder &encoder = *capture.encoder;
+    if(!encoder.recording.active)
+    {
+        return;
+    }
+
+    bool full = capture.numPending == capture.slots.size();
+    {
+        std::lock_guard<std::mutex> lock(encoder.mutex);
+        encoder.stats.requested++;
+        if(full)
+        {
+            encoder.stats.droppedInFlight++;
+        }
+    }
+
+    if(!full)
+    {
+        detail::issueReadback(capture, std::string(), true);
+    }
+}
+
+CaptureStats captureStopRecording(Capture &capture)
+{
+    CaptureEncoder &encoder = *capture.encoder;
+    if(!encoder.recording.active)
+    {
+        return CaptureStats();
+    }
+
+    detail::flush(capture);
+
+    CaptureRecording &recording = encoder.recording;
+    recording.active = false;
+    if(recording.file.is_open())
+    {
+        recording.file.close();
+    }
+
+    CaptureStats stats;
+    {
+        std::lock_guard<std::mutex> lock(encoder.mutex);
+        stats = encoder.stats;
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - recording.start).count();
+    std::cout << "[Capture] Recorded " << stats.written << "/" << stats.requested << " frames to " << recording.path;
+    if(recording.format == CaptureFormatRaw)
+    {
+        std::cout << " (raw RGBA " << recording.width << "x" << recording.height << ")";
+    }
+    std::cout << " in " << seconds << " s, avg frame " << (stats.requested ? 1000.0 * seconds / stats.requested : 0.0) << " ms"
+              << ", dropped: " << stats.droppedInFlight << " in flight, " << stats.droppedQueue << " queue full, "
+              << stats.droppedSize << " size changed" << std::endl;
+
+    return stats;
+}
+
+bool captureIsRecording(const Capture &capture)
+{
+    return capture.encoder && capture.encoder->recording.active;
+}
+
+void captureUpdate(Capture &capture)
+{
+    while (capture.numPending > 0) {
+        CaptureSlot &slot = capture.slots[detail::tail(capture)];
+
+        /* timeout 0 only polls the fence, stop at the first read back that isn't done to keep the order */
+        GLenum status = glClientWaitSync(slot.fence, 0, 0);
+        if(status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+        {
+            break;
+        }
+
+        detail::handOver(capture, slot);
+        capture.numPending--;
+    }
+}
+
+void captureDelete(Capture &capture)
+{
+    if(capture.encoder)
+    {
+        captureStopRecording(capture);
+        detail::flush(capture);
+
+        {
+            std::lock_guard<std::mutex> lock(capture.encoder->mutex);
+            capture.encoder->stop = true;
+        }
+        capture.encoder->wake.notify_all();
+    }
+    for (auto &thread : capture.encoderThreads) {
+        thread.join();
+    }
+    capture.encoderThreads.clear();
+
+    for (auto &slot : capture.slots) {
+        glDeleteBuffers(1, &slot.pbo);
+    }
+    capture.slots.clear();
+    capture.encoder.reset();
+}
@@ -0,0 +1,173 @@
+#pragma once
+
+#include "base.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum eCaptureFormat
+{
+    CaptureFormatPNG,   // numbered images <path>_000000.png, ...
+    CaptureFormatRaw,   // one file with all frames as RGBA8, top row first, no header
+    CaptureFormatY4M    // one YUV4MPEG2 file (4:4:4), playable with ffplay/mpv
+};
+
+/* pixels read back from the GPU, bottom row first as returned by glReadPixels */
+struct CaptureImage
+{
+    std::string path;
+    int width = 0;
+    int height = 0;
+    std::vector<unsigned char> pixels;  // RGBA8
+
+    bool stream = false;                // frame of a raw/Y4M recording instead of a standalone PNG
+    unsigned int sequence = 0;          // position in the stream, frames are written in this order
+};
+
+struct CaptureStats
+{
+    unsigned int requested = 0;         // frames requested while recording
+    unsigned int written = 0;           // ... written by the encoders
+    unsigned int droppedInFlight = 0;   // ... dropped because all pixel buffers were still in flight
+    unsigned int droppedQueue = 0;      // ... dropped because the encoder queue was full
+    unsigned int droppedSize = 0;       // ... dropped because the viewport size changed during a stream recording
+};
+
+/* output of a recording, shared between the encoder threads */
+struct CaptureRecording
+{
+    bool active = false;
+    eCaptureFormat format = CaptureFormatPNG;
+    std::string path;
+    unsigned int fps = 60;
+    int width = 0;                      // size of the first frame, raw/Y4M streams keep it
+    int height = 0;
+
+    std::ofstream file;
+    unsigned int nextSequence = 0;      // next stream frame to write
+    unsigned int numQueued = 0;         // frames handed to the encoders (stream sequence numbers or image numbers)
+    std::chrono::steady_clock::time_point start;
+};
+
+/* bounded queue between the render thread and the encoder threads */
+struct CaptureEncoder
+{
+    std::mutex mutex;
+    std::condition_variable wake;       // new image queued or stop
+    std::condition_variable idle;       // queue drained and no encoder busy
+    std::condition_variable streamTurn; // a stream frame was written
+    std::deque<CaptureImage> queue;
+    unsigned int maxQueue = 8;
+    unsigned int busy = 0;
+    bool stop = false;
+
+    CaptureRecording recording;
+    CaptureStats stats;
+};
+
+/* pixel buffer object that a read back was issued into, the fence signals when the copy is done */
+struct CaptureSlot
+{
+    GLuint pbo = 0;
+    GLsync fence = nullptr;
+    int width = 0;
+    int height = 0;
+    std::string path;
+    bool recording = false;
+};
+
+/* ring of pixel buffer objects, slots are filled at head and handed to the encoders in request order */
+struct Capture
+{
+    std::vector<CaptureSlot> slots;
+    unsigned int head = 0;
+    unsigned int numPending = 0;
+
+    std::vector<std::thread> encoderThreads;
+    std::unique_ptr<CaptureEncoder> encoder;
+};
+
+/**
+ * @brief Creates the pixel buffer objects and starts the encoder threads.
+ *
+ * @param numSlots Number of read backs that can be in flight at once.
+ * @param numEncoders Number of encoder threads, 0 picks half of the hardware threads.
+ * @param maxQueue Number of images that may wait for an encoder, further images are dropped.
+ *
+ * @return Capture state.
+ */
+Capture captureCreate(unsigned int numSlots = 3, unsigned int numEncoders = 0, unsigned int maxQueue = 8);
+
+/**
+ * @brief Starts an asynchronous read back of the current viewport of the back buffer (or the bound offscreen
+ * framebuffer) into the next pixel buffer object. Call it after the frame is drawn and before the buffers are swapped.
+ * Never waits for the GPU, if all slots are still in flight the request is dropped.
+ *
+ * @param capture Capture state.
+ * @param filepath Path of the PNG image written by an encoder thread.
+ *
+ * @return False if the request was dropped.
+ */
+bool captureRequest(Capture& capture, const std::string& filepath);
+
+/**
+ * @brief Starts recording, every frame passed to captureRecordFrame(...) is written to the output.
+ *
+ * @param capture Capture state.
+ * @param path Output file (raw/Y4M) or prefix of the numbered images (PNG).
+ * @param format Output format.
+ * @param fps Frame rate written to the Y4M header.
+ *
+ * @return False if the output file couldn't be opened.
+ */
+bool captureStartRecording(Capture& capture, const std::string& path, eCaptureFormat format, unsigned int fps = 60);
+
+/**
+ * @brief Captures the current frame of a recording, same as captureRequest(...) but counts into the recording
+ * statistics. Does nothing if no recording is active.
+ *
+ * @param capture Capture state.
+ */
+void captureRecordFrame(Capture& capture);
+
+/**
+ * @brief Waits for all frames of the recording to be written, closes the output and prints the statistics.
+ *
+ * @param capture Capture state.
+ *
+ * @return Statistics of the recording.
+ */
+CaptureStats captureStopRecording(Capture& capture);
+
+/**
+ * @brief Whether a recording is active.
+ */
+bool captureIsRecording(const Capture& capture);
+
+/**
+ * @brief Picks the recording format from the file extension: .y4m, .rgba/.raw and PNG otherwise.
+ */
+eCaptureFormat captureFormatFromPath(const std::string& path);
+
+/**
+ * @brief Hands all finished read backs to the encoder threads. Call once per frame, it only polls the fences and
+ * never waits for the GPU.
+ *
+ * @param capture Capture state.
+ */
+void captureUpdate(Capture& capture);
+
+/**
+ * @brief Stops an active recording, waits for all read backs in flight and the encoders to finish, then deletes the
+ * pixel buffer objects.
+ *
+ * @param capture Capture state to delete.
+ */
+void captureDelete(Capture& capture);
@@ -0,0 +1,135 @@
+#include "culling.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CULLING_USE_SSE 1
+#include <emmintrin.h>
+#endif
+
+namespace detail
+{
+    Vector4D row(const Matrix4D &M, int i)
+    {
+        return Vector4D(M(i, 0), M(i, 1), M(i, 2), M(i, 3));
+    }
+
+    Vector4D normalizePlane(const Vector4D &p)
+    {
+        float len = std::sqrt(p.x * p.x + p.y * p.y + p.z * p.z);
+        return len > 0.0f ? p / len : p;
+    }
+
+    bool sphereVisible(const Frustum &frustum, const BoundingSphere &s)
+    {
+        for (const auto &p : frustum.planes) {
+            if (p.x * s.center.x + p.y * s.center.y + p.z * s.center.z + p.w < -s.radius) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+Frustum frustumCreate(const Matrix4D &viewProjection)
+{
+    Vector4D r0 = detail::row(viewProjection, 0);
+    Vector4D r1 = detail::row(viewProjection, 1);
+    Vector4D r2 = detail::row(viewProjection, 2);
+    Vector4D r3 = detail::row(viewProjection, 3);
+
+    Frustum frustum;
+    frustum.planes[0] = detail::normalizePlane(r3 + r0); // left
+    frustum.planes[1] = detail::normalizePlane(r3 - r0); // right
+    frustum.planes[2] = detail::normalizePlane(r3 + r1); // bottom
+    frustum.planes[3] = detail::normalizePlane(r3 - r1); // top
+    frustum.planes[4] = detail::normalizePlane(r3 + r2); // near
+    frustum.planes[5] = detail::normalizePlane(r3 - r2); // far
+    return frustum;
+}
+
+BoundingSphere boundsTransform(const Mesh &mesh, const Matrix4D &model)
+{
+    Vector4D center = model * Vector4D(mesh.boundsCenter, 1.0f);
+
+    float sx = length(Vector3D(model(0, 0), model(1, 0), model(2, 0)));
+    float sy = length(Vector3D(model(0, 1), model(1, 1), model(2, 1)));
+    float sz = length(Vector3D(model(0, 2), model(1, 2), model(2, 2)));
+
+    return {Vector3D(center.x, center.y, center.z), mesh.boundsRadius * std::max({sx, sy, sz})};
+}
+
+namespace detail
+{
+    /* tests a batch of spheres against the frustum, four spheres at a time with SSE when available: visible[i] gets 1
+     * (visible) or 0 (culled), the tested and culled spheres are added to the stats */
+    void cullSphereArray(const Frustum &frustum, const BoundingSphere *spheres, std::size_t count, unsigned char *visible, CullStats &stats)
+    {
+        static_assert(sizeof(BoundingSphere) == 4 * sizeof(float), "BoundingSphere has to be tightly packed");
+
+        std::size_t i = 0;
+
+#ifdef CULLING_USE_SSE
+        /* four spheres per iteration: transpose AoS (x, y, z, r) into SoA registers and test all six planes */
+        const float *data = reinterpret_cast<const float *>(spheres);
+        for (; i + 4 <= count; i += 4) {
+            __m128 x = _mm_loadu_ps(data + 4 * i + 0);
+            __m128 y = _mm_loadu_ps(data + 4 * i + 4);
+            __m128 z = _mm_loadu_ps(data + 4 * i + 8);
+            __m128 r = _mm_loadu_ps(data + 4 * i + 12);
+            _MM_TRANSPOSE4_PS(x, y, z, r);
+
+            __m128 negR = _mm_sub_ps(_mm_setzero_ps(), r);
+            __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+            for (const auto &p : frustum.planes) {
+                __m128 d = _mm_add_ps(
+                    _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(p.x)), _mm_mul_ps(y, _mm_set1_ps(p.y))),
+                    _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(p.z)), _mm_set1_ps(p.w)));
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(d, negR));
+            }
+
+            int mask = _mm_movemask_ps(inside);
+            for (int k = 0; k < 4; k++) {
+                visible[i + k] = (mask >> k) & 1;
+            }
+        }
+#endif
+
+        for (; i < count; i++) {
+            visible[i] = detail::sphereVisible(frustum, spheres[i]);
+        }
+
+        stats.tested += count;
+        stats.culled += count - std::count(visible, visible + count, 1);
+    }
+}
+
+void cullDrawItems(const std::vector<Frustum> &frustums, FrameVector<DrawItem> &items, CullStats &stats)
+{
+    FrameVector<BoundingSphere> spheres(items.size(), items.get_allocator());
+    for (std::size_t i = 0; i < items.size(); i++) {
+        spheres[i] = boundsTransform(items[i].mesh, items[i].model);
+        items[i].viewMask = 0;
+    }
+
+    FrameVector<unsigned char> visible(items.size(), items.get_allocator());
+    CullStats viewStats;
+    for (std::size_t v = 0; v < frustums.size(); v++) {
+        detail::cullSphereArray(frustums[v], spheres.data(), spheres.size(), visible.data(), viewStats);
+        for (std::size_t i = 0; i < items.size(); i++) {
+            items[i].viewMask |= static_cast<unsigned int>(visible[i]) << v;
+        }
+    }
+
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < items.size(); i++) {
+        if (items[i].viewMask) {
+            items[n++] = items[i];
+        }
+    }
+    stats.tested += items.size();
+    stats.culled += items.size() - n;
+    items.resize(n);
+}
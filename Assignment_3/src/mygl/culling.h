@@ -0,0 +1,68 @@
+#pragma once
+
+#include "framearena.h"
+#include "mesh.h"
+
+#include <vector>
+
+/* object index of draw items that don't belong to an object (e.g. the ground) */
+#define DRAW_NO_OBJECT 0xffffffffu
+
+/* a mesh placed in the world, the unit that gets culled and drawn */
+struct DrawItem
+{
+    Mesh mesh;
+    Matrix4D model;
+    unsigned int object = DRAW_NO_OBJECT;   // e.g. index of the vehicle the part belongs to
+    unsigned int viewMask = ~0u;            // bit i set: visible in view i (see ViewSet)
+};
+
+/* six planes (a, b, c, d) with normalized normals pointing inside: a*x + b*y + c*z + d >= 0 for points inside */
+struct Frustum
+{
+    Vector4D planes[6];
+};
+
+/* 16 byte sphere, so four of them can be loaded and transposed into SIMD registers at once */
+struct BoundingSphere
+{
+    Vector3D center;
+    float radius;
+};
+
+struct CullStats
+{
+    unsigned int tested = 0;
+    unsigned int culled = 0;
+};
+
+/**
+ * @brief Extracts the view frustum planes from a combined projection * view matrix (Gribb/Hartmann).
+ *
+ * @param viewProjection Projection matrix multiplied with the view matrix.
+ *
+ * @return Frustum with normalized planes in world space.
+ */
+Frustum frustumCreate(const Matrix4D& viewProjection);
+
+/**
+ * @brief Transforms the local bounding sphere of a mesh into world space. The radius is scaled with the largest axis
+ * scale of the model matrix, so the sphere stays conservative for non-uniform scales.
+ *
+ * @param mesh Mesh with computed bounds (see meshComputeBounds(...)).
+ * @param model Model matrix of the mesh instance.
+ *
+ * @return Bounding sphere in world space.
+ */
+BoundingSphere boundsTransform(const Mesh& mesh, const Matrix4D& model);
+
+/**
+ * @brief Culls draw items against several views at once: the world spheres are computed once and tested against every
+ * frustum, each item gets the bit mask of the views that see it and items seen by no view are removed. The scratch
+ * buffers come from the allocator of the items (the frame arena of the calling thread).
+ *
+ * @param frustums Frustum of each view (at most 32).
+ * @param items Draw items, viewMask is set and culled items are removed (the order of the remaining items is kept).
+ * @param stats Statistics that get the number of tested items and of items culled in all views added.
+ */
+void cullDrawItems(const std::vector<Frustum>& frustums, FrameVector<DrawItem>& items, CullStats& stats);
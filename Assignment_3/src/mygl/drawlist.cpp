@@ -0,0 +1,93 @@
+#include "drawlist.h"
+
+#include <algorithm>
+
+namespace detail
+{
+    /* commands without an object (occluders such as the terrain) first, then by key */
+    bool commandBefore(const DrawCommand &a, const DrawCommand &b)
+    {
+        bool aObject = a.object != DRAW_NO_OBJECT;
+        bool bObject = b.object != DRAW_NO_OBJECT;
+        return aObject != bObject ? bObject : a.key < b.key;
+    }
+}
+
+void drawListClear(DrawList &list)
+{
+    list.commands.clear();
+    list.cullStats = CullStats();
+    list.lodStats = LodStats();
+}
+
+void drawListAdd(DrawList &list, const DrawItem &item)
+{
+    DrawCommand command;
+    command.key = (static_cast<std::uint64_t>(item.mesh.vao) << 32) | item.object;
+    command.object = item.object;
+    command.viewMask = item.viewMask;
+    command.vao = item.mesh.vao;
+    command.count = item.mesh.size_ibo;
+    command.firstIndex = item.mesh.firstIndex;
+    command.baseVertex = item.mesh.baseVertex;
+    command.model = item.model;
+    list.commands.push_back(command);
+}
+
+void drawListSort(DrawList &list)
+{
+    std::stable_sort(list.commands.begin(), list.commands.end(), detail::commandBefore);
+}
+
+void drawListMerge(const std::vector<DrawList> &lists, DrawList &merged)
+{
+    drawListClear(merged);
+
+    std::size_t total = 0;
+    for (const auto &list : lists) {
+        total += list.commands.size();
+    }
+    merged.commands.reserve(total);
+
+    /* the lists are few (one per worker), so the smallest head is found by a linear scan; the first list wins ties */
+    merged.mergeHeads.assign(lists.size(), 0);
+    while (merged.commands.size() < total) {
+        std::size_t best = lists.size();
+        for (std::size_t l = 0; l < lists.size(); l++) {
+            if (merged.mergeHeads[l] < lists[l].commands.size()
+                && (best == lists.size() || detail::commandBefore(lists[l].commands[merged.mergeHeads[l]], lists[best].commands[merged.mergeHeads[best]]))) {
+                best = l;
+            }
+        }
+        merged.commands.push_back(lists[best].commands[merged.mergeHeads[best]++]);
+    }
+
+    for (const auto &list : lists) {
+        merged.cullStats.tested += list.cullStats.tested;
+        merged.cullStats.culled += list.cullStats.culled;
+        merged.lodStats.selected += list.lodStats.selected;
+        merged.lodStats.trianglesFull += list.lodStats.trianglesFull;
+        merged.lodStats.trianglesDrawn += list.lodStats.trianglesDrawn;
+    }
+}
+
+std::size_t drawListObjectsBegin(const DrawList &list)
+{
+    return std::partition_point(list.commands.begin(), list.commands.end(), [](const DrawCommand &command) { return command.object == DRAW_NO_OBJECT; }) - list.commands.begin();
+}
+
+void drawListReplayRange(const DrawList &list, const ShaderProgram &shader, std::size_t begin, std::size_t end, unsigned int viewMask, GLuint &boundVao)
+{
+    for (std::size_t i = begin; i < end; i++) {
+        const DrawCommand &command = list.commands[i];
+        if (!(command.viewMask & viewMask)) {
+            continue;
+        }
+        if (command.vao != boundVao) {
+            glBindVertexArray(command.vao);
+            boundVao = command.vao;
+        }
+        glUniformMatrix4fv(shader.modelLocation, 1, GL_FALSE, command.model.ptr());
+        glDrawElementsBaseVertex(GL_TRIANGLES, command.count, GL_UNSIGNED_INT, (void*) (command.firstIndex * sizeof(unsigned int)), command.baseVertex);
+    }
+}
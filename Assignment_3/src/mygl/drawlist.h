@@ -0,0 +1,85 @@
+#pragma once
+
+#include "culling.h"
+#include "lod.h"
+#include "mesh.h"
+#include "shader.h"
+
+#include <cstdint>
+#include <vector>
+
+/* everything the GL thread needs to issue one draw call, filled by the frame preparation workers */
+struct DrawCommand
+{
+    std::uint64_t key = 0;  // sort key: vertex array object, then object (after the commands without object)
+    unsigned int object = DRAW_NO_OBJECT;
+    unsigned int viewMask = ~0u;    // views that replay the command
+    GLuint vao = 0;
+    GLsizei count = 0;
+    unsigned int firstIndex = 0;
+    GLint baseVertex = 0;
+    Matrix4D model;
+};
+
+struct DrawList
+{
+    std::vector<DrawCommand> commands;
+    CullStats cullStats;
+    LodStats lodStats;
+    std::vector<std::size_t> mergeHeads;    // scratch of drawListMerge(...), kept so merging doesn't allocate
+};
+
+/**
+ * @brief Removes all commands and resets the statistics, the memory of the list is kept.
+ *
+ * @param list Draw list to clear.
+ */
+void drawListClear(DrawList& list);
+
+/**
+ * @brief Appends the draw command for a mesh instance.
+ *
+ * @param list Draw list the command is added to.
+ * @param item Mesh, model matrix and owning object of the instance.
+ */
+void drawListAdd(DrawList& list, const DrawItem& item);
+
+/**
+ * @brief Sorts the commands, the ones without object (occluders such as the terrain) first and all of them by their
+ * key, so consecutive commands share the vertex array object and the commands of one object are contiguous.
+ *
+ * @param list Draw list to sort.
+ */
+void drawListSort(DrawList& list);
+
+/**
+ * @brief Merges several sorted draw lists (e.g. one per worker) into one sorted list and sums up their statistics.
+ * Commands with equal keys keep the order of the lists. A single k-way merge, each command is copied once.
+ *
+ * @param lists Sorted draw lists.
+ * @param merged Output list, cleared before merging.
+ */
+void drawListMerge(const std::vector<DrawList>& lists, DrawList& merged);
+
+/**
+ * @brief Index of the first command that belongs to an object, the commands before it have none.
+ *
+ * @param list Sorted draw list.
+ *
+ * @return Index of the first object command, the size of the list if there is none.
+ */
+std::size_t drawListObjectsBegin(const DrawList& list);
+
+/**
+ * @brief Issues the draw calls of the commands [begin, end) of the list. The shader has to be in use and all uniforms
+ * except uModel have to be set.
+ *
+ * @param list Draw list to replay.
+ * @param shader Shader program in use, uModel is set per command.
+ * @param begin First command.
+ * @param end One past the last command.
+ * @param viewMask Only commands that share a bit with it are drawn (e.g. 1u << view).
+ * @param boundVao Vertex array object currently bound (0 if unknown), updated by the replay so consecutive ranges
+ * don't bind it again.
+ */
+void drawListReplayRange(const DrawList& list, const ShaderProgram& shader, std::size_t begin, std::size_t end, unsigned int viewMask, GLuint& boundVao);
@@ -0,0 +1,109 @@
+#include "dynamicresolution.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace detail
+{
+    /* band around the budget in which the scale is left alone, so the resolution doesn't change every frame */
+    constexpr double lowerBand = 0.8;
+    /* the scale aims slightly below the budget and moves only part of the way per adjustment, because not all of
+     * the frame time depends on the number of pixels */
+    constexpr double target = 0.9;
+    constexpr float damping = 0.5f;
+
+    void applyScale(DynamicResolution &resolution)
+    {
+        resolution.width = std::max(1, static_cast<int>(std::lround(resolution.scale * resolution.outputWidth)));
+        resolution.height = std::max(1, static_cast<int>(std::lround(resolution.scale * resolution.outputHeight)));
+    }
+
+    void adjustScale(DynamicResolution &resolution, double gpuMs)
+    {
+        if(gpuMs <= 0.0 || (gpuMs <= resolution.budgetMs && gpuMs >= lowerBand * resolution.budgetMs))
+        {
+            return;
+        }
+
+        /* the cost of the pixels grows with the area, i.e. with the square of the scale per axis */
+        float desired = resolution.scale * static_cast<float>(std::sqrt(target * resolution.budgetMs / gpuMs));
+        float scale = resolution.scale + damping * (desired - resolution.scale);
+        resolution.scale = std::clamp(scale, resolution.minScale, 1.0f);
+        applyScale(resolution);
+    }
+}
+
+DynamicResolution dynamicResolutionCreate(int width, int height, double budgetMs, float minScale)
+{
+    DynamicResolution resolution;
+    resolution.framebuffer = framebufferCreate(width, height);
+    resolution.outputWidth = width;
+    resolution.outputHeight = height;
+    resolution.budgetMs = budgetMs;
+    resolution.minScale = std::clamp(minScale, 0.05f, 1.0f);
+    detail::applyScale(resolution);
+    glGenQueries(2 * DYNAMIC_RESOLUTION_FRAMES, resolution.queries);
+    return resolution;
+}
+
+void dynamicResolutionResize(DynamicResolution &resolution, int width, int height)
+{
+    if(width <= 0 || height <= 0)
+    {
+        return;
+    }
+
+    framebufferResize(resolution.framebuffer, width, height);
+    resolution.outputWidth = width;
+    resolution.outputHeight = height;
+    detail::applyScale(resolution);
+}
+
+void dynamicResolutionBegin(DynamicResolution &resolution)
+{
+    /* the slot of this frame was used DYNAMIC_RESOLUTION_FRAMES frames ago, its result is usually ready by now */
+    unsigned int slot = resolution.frame % DYNAMIC_RESOLUTION_FRAMES;
+    if(resolution.issued[slot])
+    {
+        GLuint available = GL_FALSE;
+        glGetQueryObjectuiv(resolution.queries[2 * slot + 1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if(available)
+        {
+            GLuint64 begin = 0, end = 0;
+            glGetQueryObjectui64v(resolution.queries[2 * slot], GL_QUERY_RESULT, &begin);
+            glGetQueryObjectui64v(resolution.queries[2 * slot + 1], GL_QUERY_RESULT, &end);
+            resolution.gpuTimeMs = static_cast<double>(end - begin) / 1.0e6;
+            detail::adjustScale(resolution, resolution.gpuTimeMs);
+        }
+        /* otherwise the measurement is skipped, waiting for it would stall the pipeline */
+        resolution.issued[slot] = false;
+    }
+
+    /* timestamps instead of GL_TIME_ELAPSED, the occlusion pass uses an elapsed query inside the frame */
+    glQueryCounter(resolution.queries[2 * slot], GL_TIMESTAMP);
+
+    framebufferBind(resolution.framebuffer);
+    glViewport(0, 0, resolution.width, resolution.height);
+}
+
+void dynamicResolutionEnd(DynamicResolution &resolution, GLuint target)
+{
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, resolution.framebuffer.id);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, target);
+    glBlitFramebuffer(0, 0, resolution.width, resolution.height, 0, 0, resolution.outputWidth, resolution.outputHeight,
+                      GL_COLOR_BUFFER_BIT, GL_LINEAR);
+    glBindFramebuffer(GL_FRAMEBUFFER, target);
+    glViewport(0, 0, resolution.outputWidth, resolution.outputHeight);
+
+    unsigned int slot = resolution.frame % DYNAMIC_RESOLUTION_FRAMES;
+    glQueryCounter(resolution.queries[2 * slot + 1], GL_TIMESTAMP);
+    resolution.issued[slot] = true;
+    resolution.frame++;
+}
+
+void dynamicResolutionDelete(DynamicResolution &resolution)
+{
+    glDeleteQueries(2 * DYNAMIC_RESOLUTION_FRAMES, resolution.queries);
+    framebufferDelete(resolution.framebuffer);
+    resolution = DynamicResolution();
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "framebuffer.h"
+
+/* GPU frames in flight before their timestamps are read */
+constexpr unsigned int DYNAMIC_RESOLUTION_FRAMES = 3;
+
+/* renders into a part of an offscreen framebuffer whose size follows the measured GPU frame time, the final pass
+ * upscales it to the output */
+struct DynamicResolution
+{
+    Framebuffer framebuffer;    // allocated at output size, only the scaled part is rendered to
+    int outputWidth = 0;
+    int outputHeight = 0;
+
+    double budgetMs = 16.0;     // GPU frame time to hold
+    float minScale = 0.25f;     // lower bound of the scale per axis
+    float scale = 1.0f;         // current scale per axis
+    int width = 0;              // current render size
+    int height = 0;
+
+    /* begin/end timestamp per frame, read DYNAMIC_RESOLUTION_FRAMES frames later */
+    GLuint queries[2 * DYNAMIC_RESOLUTION_FRAMES] = {};
+    bool issued[DYNAMIC_RESOLUTION_FRAMES] = {};
+    unsigned int frame = 0;
+    double gpuTimeMs = 0.0;     // last measured GPU frame time
+};
+
+/**
+ * @brief Creates the offscreen framebuffer and the timer queries, rendering starts at full resolution.
+ *
+ * @param width Output width in pixels.
+ * @param height Output height in pixels.
+ * @param budgetMs GPU frame time budget in milliseconds.
+ * @param minScale Smallest scale per axis the resolution may drop to.
+ *
+ * @return Dynamic resolution state.
+ */
+DynamicResolution dynamicResolutionCreate(int width, int height, double budgetMs, float minScale = 0.25f);
+
+/**
+ * @brief Adapts to a new output size (call from the window resize callback), keeps the current scale.
+ *
+ * @param resolution Dynamic resolution state.
+ * @param width New output width in pixels.
+ * @param height New output height in pixels.
+ */
+void dynamicResolutionResize(DynamicResolution& resolution, int width, int height);
+
+/**
+ * @brief Reads the GPU time of an older frame, adjusts the scale if it is outside the budget and binds the offscreen
+ * framebuffer with the viewport set to the scaled size.
+ *
+ * @param resolution Dynamic resolution state.
+ */
+void dynamicResolutionBegin(DynamicResolution& resolution);
+
+/**
+ * @brief Upscales the rendered part to the whole target framebuffer (linear filtering) and leaves the target bound.
+ *
+ * @param resolution Dynamic resolution state.
+ * @param target Framebuffer object to present to, 0 for the default framebuffer.
+ */
+void dynamicResolutionEnd(DynamicResolution& resolution, GLuint target = 0);
+
+/**
+ * @brief Deletes the framebuffer and the queries.
+ *
+ * @param resolution Dynamic resolution state.
+ */
+void dynamicResolutionDelete(DynamicResolution& resolution);
@@ -0,0 +1,111 @@
+#include "framearena.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+namespace detail
+{
+    std::size_t alignUp(std::size_t value, std::size_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    void subArenaRelease(FrameSubArena &sub)
+    {
+        for (void *block : sub.overflow) {
+            ::operator delete(block);
+        }
+        sub.overflow.clear();
+        sub.used = 0;
+        sub.overflowBytes = 0;
+        sub.peak = 0;
+    }
+}
+
+FrameArena frameArenaCreate(unsigned int numSubArenas, std::size_t capacity)
+{
+    FrameArena arena;
+    arena.subArenas.resize(std::max(numSubArenas, 1u));
+    for (auto &sub : arena.subArenas) {
+        sub.capacity = capacity;
+        sub.data = capacity ? static_cast<unsigned char *>(::operator new(capacity)) : nullptr;
+    }
+    return arena;
+}
+
+void frameArenaReset(FrameArena &arena)
+{
+    for (auto &sub : arena.subArenas) {
+        sub.highWater = std::max(sub.highWater, sub.peak);
+        if(!sub.overflow.empty())
+        {
+            /* the next power of two, so a slowly growing frame doesn't grow the arena every time */
+            std::size_t capacity = std::max<std::size_t>(sub.capacity, 4096);
+            while (capacity < sub.highWater) {
+                capacity *= 2;
+            }
+            ::operator delete(sub.data);
+            sub.data = static_cast<unsigned char *>(::operator new(capacity));
+            sub.capacity = capacity;
+            arena.grows++;
+        }
+        detail::subArenaRelease(sub);
+    }
+    arena.frames++;
+}
+
+FrameSubArena &frameArenaSub(FrameArena &arena, unsigned int index)
+{
+    return arena.subArenas[index];
+}
+
+void *frameArenaAlloc(FrameSubArena &sub, std::size_t size, std::size_t alignment)
+{
+    /* align the address, not the offset, the block itself is only aligned for fundamental types */
+    std::uintptr_t base = reinterpret_cast<std::uintptr_t>(sub.data);
+    std::size_t offset = detail::alignUp(base + sub.used, alignment) - base;
+    if(sub.data && offset + size <= sub.capacity)
+    {
+        sub.used = offset + size;
+        sub.peak = std::max(sub.peak, sub.used + sub.overflowBytes);
+        return sub.data + offset;
+    }
+
+    void *block = ::operator new(size + alignment);
+    sub.overflow.push_back(block);
+    sub.overflowBytes += size + alignment;
+    sub.peak = std::max(sub.peak, sub.used + sub.overflowBytes);
+    return reinterpret_cast<void *>(detail::alignUp(reinterpret_cast<std::uintptr_t>(block), alignment));
+}
+
+void frameArenaFree(FrameSubArena &sub, void *block, std::size_t size)
+{
+    unsigned char *bytes = static_cast<unsigned char *>(block);
+    if(sub.data && bytes >= sub.data && bytes + size == sub.data + sub.used)
+    {
+        sub.used = static_cast<std::size_t>(bytes - sub.data);
+    }
+}
+
+FrameArenaStats frameArenaStats(const FrameArena &arena)
+{
+    FrameArenaStats stats;
+    for (const auto &sub : arena.subArenas) {
+        stats.capacity += sub.capacity;
+        stats.used += sub.peak;
+        stats.highWater += std::max(sub.highWater, sub.peak);
+        stats.overflowAllocations += sub.overflow.size();
+    }
+    stats.grows = arena.grows;
+    return stats;
+}
+
+void frameArenaDelete(FrameArena &arena)
+{
+    for (auto &sub : arena.subArenas) {
+        detail::subArenaRelease(sub);
+        ::operator delete(sub.data);
+    }
+    arena = FrameArena();
+}
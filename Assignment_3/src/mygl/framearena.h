@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/* One block of memory that a single thread bumps through during a frame. Allocations that don't fit anymore go to
+ * the heap and make the block grow to its high-water mark at the next reset, so after a few frames a frame doesn't
+ * allocate at all. Aligned to a cache line so neighbouring sub-arenas of different threads don't share one. */
+struct alignas(64) FrameSubArena
+{
+    unsigned char *data = nullptr;
+    std::size_t capacity = 0;
+    std::size_t used = 0;
+    std::size_t overflowBytes = 0;      // bytes of this frame that didn't fit
+    std::size_t peak = 0;               // largest used + overflowBytes of this frame
+    std::size_t highWater = 0;          // largest peak of all frames
+    std::vector<void *> overflow;       // heap blocks of this frame, freed by the reset
+};
+
+/* Bump allocator for transient per-frame data (draw items, culling scratch, ...), reset once per frame. Every thread
+ * that allocates in parallel uses its own sub-arena, e.g. one per chunk index of threadPoolParallelFor(...) and one
+ * for the main thread, so allocating needs no synchronization. Nothing allocated from it may outlive the frame. */
+struct FrameArena
+{
+    std::vector<FrameSubArena> subArenas;
+    unsigned long long frames = 0;
+    unsigned long long grows = 0;       // number of times a sub-arena was enlarged
+};
+
+struct FrameArenaStats
+{
+    std::size_t capacity = 0;           // bytes of all sub-arenas
+    std::size_t used = 0;               // peak bytes of the current frame
+    std::size_t highWater = 0;          // sum of the high-water marks of the sub-arenas
+    std::size_t overflowAllocations = 0;    // heap allocations of the current frame
+    unsigned long long grows = 0;
+};
+
+/**
+ * @brief Creates an arena with a number of equally sized sub-arenas.
+ *
+ * @param numSubArenas Number of threads that allocate in parallel (e.g. threadPoolSize(pool) + 1).
+ * @param capacity Initial bytes per sub-arena (grows when a frame needs more).
+ *
+ * @return Frame arena.
+ */
+FrameArena frameArenaCreate(unsigned int numSubArenas, std::size_t capacity);
+
+/**
+ * @brief Starts a new frame: everything allocated during the last one is released, sub-arenas that overflowed grow to
+ * their high-water mark.
+ *
+ * @param arena Frame arena.
+ */
+void frameArenaReset(FrameArena& arena);
+
+/**
+ * @brief Sub-arena of a thread.
+ *
+ * @param arena Frame arena.
+ * @param index Index of the sub-arena (< number of sub-arenas).
+ *
+ * @return Sub-arena, only used by one thread at a time.
+ */
+FrameSubArena& frameArenaSub(FrameArena& arena, unsigned int index);
+
+/**
+ * @brief Allocates memory for the rest of the frame.
+ *
+ * @param sub Sub-arena of the calling thread.
+ * @param size Number of bytes.
+ * @param alignment Alignment (power of two).
+ *
+ * @return Memory block, never nullptr (falls back to the heap if the sub-arena is full).
+ */
+void *frameArenaAlloc(FrameSubArena& sub, std::size_t size, std::size_t alignment);
+
+/**
+ * @brief Gives back a block early. Only the most recent block of the sub-arena is reclaimed (e.g. the old storage of
+ * scratch buffers freed in reverse order), other blocks stay used until the reset.
+ *
+ * @param sub Sub-arena the block came from.
+ * @param block Block returned by frameArenaAlloc(...).
+ * @param size Size the block was allocated with.
+ */
+void frameArenaFree(FrameSubArena& sub, void *block, std::size_t size);
+
+/**
+ * @brief Usage of all sub-arenas.
+ *
+ * @param arena Frame arena.
+ *
+ * @return Statistics.
+ */
+FrameArenaStats frameArenaStats(const FrameArena& arena);
+
+/**
+ * @brief Frees all memory of the arena.
+ *
+ * @param arena Frame arena to delete.
+ */
+void frameArenaDelete(FrameArena& arena);
+
+/* STL allocator on a sub-arena, e.g. FrameVector<DrawItem> items(FrameAllocator<DrawItem>(sub)). A default
+ * constructed allocator uses the heap, so the same containers work outside of a frame. */
+template <typename T>
+struct FrameAllocator
+{
+    using value_type = T;
+
+    FrameSubArena *sub = nullptr;
+
+    FrameAllocator() = default;
+    explicit FrameAllocator(FrameSubArena& sub) : sub(&sub) {}
+    template <typename U>
+    FrameAllocator(const FrameAllocator<U>& other) : sub(other.sub) {}
+
+    T *allocate(std::size_t n)
+    {
+        if(!sub)
+        {
+            return static_cast<T *>(::operator new(n * sizeof(T)));
+        }
+        return static_cast<T *>(frameArenaAlloc(*sub, n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T *block, std::size_t n)
+    {
+        if(!sub)
+        {
+            ::operator delete(block);
+            return;
+        }
+        frameArenaFree(*sub, block, n * sizeof(T));
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const FrameAllocator<T>& a, const FrameAllocator<U>& b)
+{
+    return a.sub == b.sub;
+}
+
+template <typename T, typename U>
+bool operator!=(const FrameAllocator<T>& a, const FrameAllocator<U>& b)
+{
+    return a.sub != b.sub;
+}
+
+template <typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
@@ -0,0 +1,108 @@
+#include "framebuffer.h"
+
+#include <iostream>
+#include <stdexcept>
+
+namespace detail
+{
+    void allocateAttachments(Framebuffer &framebuffer, int width, int height)
+    {
+        framebuffer.width = width;
+        framebuffer.height = height;
+
+        glBindTexture(GL_TEXTURE_2D, framebuffer.color);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        glBindRenderbuffer(GL_RENDERBUFFER, framebuffer.depth);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    }
+}
+
+Framebuffer framebufferCreate(int width, int height)
+{
+    Framebuffer framebuffer;
+    glGenFramebuffers(1, &framebuffer.id);
+    glGenTextures(1, &framebuffer.color);
+    glGenRenderbuffers(1, &framebuffer.depth);
+
+    detail::allocateAttachments(framebuffer, width, height);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer.id);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, framebuffer.color, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, framebuffer.depth);
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    if(status != GL_FRAMEBUFFER_COMPLETE)
+    {
+        std::cerr << "[Framebuffer] Framebuffer incomplete (status 0x" << std::hex << status << std::dec << ")" << std::endl;
+        std::cerr.flush();
+        framebufferDelete(framebuffer);
+        throw std::runtime_error("[Framebuffer] Framebuffer incomplete");
+    }
+
+    return framebuffer;
+}
+
+void framebufferResize(Framebuffer &framebuffer, int width, int height)
+{
+    if(framebuffer.width == width && framebuffer.height == height)
+    {
+        return;
+    }
+    detail::allocateAttachments(framebuffer, width, height);
+}
+
+void framebufferBind(const Framebuffer &framebuffer)
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer.id);
+    glViewport(0, 0, framebuffer.width, framebuffer.height);
+}
+
+void framebufferDelete(Framebuffer &framebuffer)
+{
+    glDeleteFramebuffers(1, &framebuffer.id);
+    glDeleteTextures(1, &framebuffer.color);
+    glDeleteRenderbuffers(1, &framebuffer.depth);
+    framebuffer = Framebuffer();
+}
+
+FrameFences frameFencesCreate(unsigned int maxFramesInFlight)
+{
+    FrameFences frames;
+    frames.fences.resize(maxFramesInFlight > 0 ? maxFramesInFlight : 1, nullptr);
+    return frames;
+}
+
+void frameFencesAdvance(FrameFences &frames)
+{
+    frames.fences[frames.head] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    frames.head = (frames.head + 1) % frames.fences.size();
+
+    /* the slot that gets reused next frame holds the oldest frame in flight */
+    GLsync &oldest = frames.fences[frames.head];
+    if(oldest)
+    {
+        glClientWaitSync(oldest, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+        glDeleteSync(oldest);
+        oldest = nullptr;
+    }
+}
+
+void frameFencesDelete(FrameFences &frames)
+{
+    for (auto &fence : frames.fences) {
+        if(fence)
+        {
+            glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+}
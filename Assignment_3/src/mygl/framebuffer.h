@@ -0,0 +1,81 @@
+#pragma once
+
+#include "base.h"
+
+#include <vector>
+
+/* offscreen render target with an RGBA8 color texture and a depth renderbuffer */
+struct Framebuffer
+{
+    GLuint id = 0;
+    GLuint color = 0;
+    GLuint depth = 0;
+    int width = 0;
+    int height = 0;
+};
+
+/**
+ * @brief Creates a framebuffer object with a color texture and a depth renderbuffer of the given size.
+ *
+ * @param width Width in pixels.
+ * @param height Height in pixels.
+ *
+ * @return Complete framebuffer.
+ *
+ * @throws std::runtime_error if the framebuffer isn't complete.
+ */
+Framebuffer framebufferCreate(int width, int height);
+
+/**
+ * @brief Reallocates the attachments if the size differs, the content is undefined afterwards.
+ *
+ * @param framebuffer Framebuffer to resize.
+ * @param width New width in pixels.
+ * @param height New height in pixels.
+ */
+void framebufferResize(Framebuffer& framebuffer, int width, int height);
+
+/**
+ * @brief Binds the framebuffer for drawing and reading and sets the viewport to its size.
+ *
+ * @param framebuffer Framebuffer to bind.
+ */
+void framebufferBind(const Framebuffer& framebuffer);
+
+/**
+ * @brief Deletes the framebuffer object and its attachments.
+ *
+ * @param framebuffer Framebuffer to delete.
+ */
+void framebufferDelete(Framebuffer& framebuffer);
+
+/* fences of the last frames, used to bound the frames in flight when no swap chain paces the application */
+struct FrameFences
+{
+    std::vector<GLsync> fences;
+    unsigned int head = 0;
+};
+
+/**
+ * @brief Creates the fence ring.
+ *
+ * @param maxFramesInFlight Number of frames the GPU may lag behind the CPU.
+ *
+ * @return Fence ring without fences.
+ */
+FrameFences frameFencesCreate(unsigned int maxFramesInFlight = 2);
+
+/**
+ * @brief Call at the end of a frame: inserts a fence for the frame and waits until the frame maxFramesInFlight frames
+ * back is finished on the GPU.
+ *
+ * @param frames Fence ring.
+ */
+void frameFencesAdvance(FrameFences& frames);
+
+/**
+ * @brief Waits for all frames in flight and deletes the fences.
+ *
+ * @param frames Fence ring to delete.
+ */
+void frameFencesDelete(FrameFences& frames);
@@ -0,0 +1,122 @@
+#include "framepacing.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+
+FrameLimiter frameLimiterCreate(double fps)
+{
+    FrameLimiter limiter;
+    if(fps > 0.0)
+    {
+        limiter.period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / fps));
+    }
+    limiter.next = std::chrono::steady_clock::now() + limiter.period;
+    return limiter;
+}
+
+void frameLimiterWait(FrameLimiter &limiter)
+{
+    if(limiter.period.count() == 0)
+    {
+        return;
+    }
+
+    /* sleep_for overshoots by up to a scheduler tick, so only sleep until shortly before the deadline */
+    auto now = std::chrono::steady_clock::now();
+    if(limiter.next - now > limiter.spinMargin)
+    {
+        std::this_thread::sleep_for(limiter.next - now - limiter.spinMargin);
+    }
+    while (std::chrono::steady_clock::now() < limiter.next) {
+        std::this_thread::yield();
+    }
+
+    now = std::chrono::steady_clock::now();
+    limiter.next += limiter.period;
+    if(limiter.next < now)
+    {
+        limiter.next = now + limiter.period;
+    }
+}
+
+FrameHistogram frameHistogramCreate(unsigned int windowSize, double maxMs, double bucketWidthMs)
+{
+    FrameHistogram histogram;
+    histogram.bucketWidth = bucketWidthMs;
+    histogram.buckets.assign(static_cast<std::size_t>(std::ceil(maxMs / bucketWidthMs)) + 1, 0);
+    histogram.window.assign(std::max(1u, windowSize), 0.0f);
+    return histogram;
+}
+
+namespace detail
+{
+    std::size_t bucket(const FrameHistogram &histogram, double ms)
+    {
+        double index = std::max(0.0, ms / histogram.bucketWidth);
+        return std::min(static_cast<std::size_t>(index), histogram.buckets.size() - 1);
+    }
+}
+
+void frameHistogramAdd(FrameHistogram &histogram, double ms)
+{
+    if(histogram.count == histogram.window.size())
+    {
+        float oldest = histogram.window[histogram.next];
+        histogram.buckets[detail::bucket(histogram, oldest)]--;
+        histogram.sum -= oldest;
+    }
+    else
+    {
+        histogram.count++;
+    }
+
+    /* the bucket comes from the stored float, the same value that picks the bucket when the sample is removed */
+    float sample = static_cast<float>(ms);
+    histogram.window[histogram.next] = sample;
+    histogram.next = (histogram.next + 1) % histogram.window.size();
+    histogram.buckets[detail::bucket(histogram, sample)]++;
+    histogram.sum += sample;
+}
+
+double frameHistogramPercentile(const FrameHistogram &histogram, double p)
+{
+    if(histogram.count == 0)
+    {
+        return 0.0;
+    }
+
+    /* overflow samples report the largest one in the window instead of the bucket edge */
+    unsigned int rank = static_cast<unsigned int>(std::ceil(std::clamp(p, 0.0, 1.0) * histogram.count));
+    rank = std::max(1u, rank);
+    unsigned int seen = 0;
+    for (std::size_t i = 0; i + 1 < histogram.buckets.size(); i++) {
+        seen += histogram.buckets[i];
+        if(seen >= rank)
+        {
+            return (i + 1) * histogram.bucketWidth;
+        }
+    }
+
+    float largest = 0.0f;
+    for (unsigned int i = 0; i < histogram.count; i++) {
+        largest = std::max(largest, histogram.window[i]);
+    }
+    return largest;
+}
+
+std::string frameHistogramSummary(const FrameHistogram &histogram)
+{
+    float largest = 0.0f;
+    for (unsigned int i = 0; i < histogram.count; i++) {
+        largest = std::max(largest, histogram.window[i]);
+    }
+
+    char line[160];
+    std::snprintf(line, sizeof(line), "mean %.2f p50 %.2f p95 %.2f p99 %.2f max %.2f ms (%u samples)",
+                  histogram.count ? histogram.sum / histogram.count : 0.0,
+                  frameHistogramPercentile(histogram, 0.50), frameHistogramPercentile(histogram, 0.95),
+                  frameHistogramPercentile(histogram, 0.99), largest, histogram.count);
+    return line;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+/* paces the loop to a target frame rate: sleeps for most of the remaining time and spins the rest */
+struct FrameLimiter
+{
+    std::chrono::steady_clock::duration period{0};
+    std::chrono::steady_clock::time_point next;
+    std::chrono::steady_clock::duration spinMargin = std::chrono::microseconds(1500);
+};
+
+/**
+ * @brief Creates a frame limiter.
+ *
+ * @param fps Target frame rate, 0 disables the limiter.
+ *
+ * @return Frame limiter, the first frame starts now.
+ */
+FrameLimiter frameLimiterCreate(double fps);
+
+/**
+ * @brief Waits until the next frame is due. Falls back to the current time if a frame took longer than the period, so
+ * slow frames aren't followed by a burst of fast ones.
+ *
+ * @param limiter Frame limiter.
+ */
+void frameLimiterWait(FrameLimiter& limiter);
+
+/* histogram of the last windowSize samples with fixed bucket width, percentiles without sorting */
+struct FrameHistogram
+{
+    double bucketWidth = 0.05;          // ms
+    std::vector<unsigned int> buckets;  // last bucket collects everything above the range
+    std::vector<float> window;          // ring of the last samples (ms), needed to remove them again
+    unsigned int next = 0;
+    unsigned int count = 0;
+    double sum = 0.0;
+};
+
+/**
+ * @brief Creates an empty histogram.
+ *
+ * @param windowSize Number of most recent samples the statistics cover.
+ * @param maxMs Upper end of the bucket range, larger samples land in an overflow bucket.
+ * @param bucketWidthMs Width of a bucket, the resolution of the percentiles.
+ *
+ * @return Empty histogram.
+ */
+FrameHistogram frameHistogramCreate(unsigned int windowSize = 1000, double maxMs = 100.0, double bucketWidthMs = 0.05);
+
+/**
+ * @brief Adds a sample, the oldest sample leaves the window once it is full.
+ *
+ * @param histogram Histogram.
+ * @param ms Sample in milliseconds.
+ */
+void frameHistogramAdd(FrameHistogram& histogram, double ms);
+
+/**
+ * @brief Percentile of the samples in the window (upper edge of the bucket holding it).
+ *
+ * @param histogram Histogram.
+ * @param p Percentile in [0, 1], e.g. 0.99.
+ *
+ * @return Value in milliseconds, 0 if the histogram is empty.
+ */
+double frameHistogramPercentile(const FrameHistogram& histogram, double p);
+
+/**
+ * @brief Formats mean, p50, p95, p99 and max of the window.
+ *
+ * @param histogram Histogram.
+ *
+ * @return One line summary, e.g. "mean 16.67 p50 16.65 p95 16.90 p99 17.40 max 21.02 ms (1000 samples)".
+ */
+std::string frameHistogramSummary(const FrameHistogram& histogram);
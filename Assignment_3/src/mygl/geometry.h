@@ -2,16 +2,49 @@
 
 #include "mesh.h"
 
-#include <vector>
+#include <array>
+#include <cstddef>
+
+/* Geometry is generated at compile time into constexpr std::arrays: no static initialization, and `inline
+ * constexpr` variables exist once in the program instead of once per translation unit. */
+
+namespace geometry {
+
+/* std::sin/std::cos aren't constexpr, Taylor series on [-pi, pi] are exact to float precision */
+constexpr double pi = 3.14159265358979323846;
+
+constexpr double sin(double x)
+{
+    while (x > pi) {
+        x -= 2.0 * pi;
+    }
+    while (x < -pi) {
+        x += 2.0 * pi;
+    }
+    double term = x;
+    double sum = x;
+    for (int n = 1; n < 14; n++) {
+        term *= -x * x / ((2.0 * n) * (2.0 * n + 1.0));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double cos(double x)
+{
+    return sin(x + 0.5 * pi);
+}
+
+}
 
 /* cube geometry */
 namespace cube {
 
-inline static const std::vector<Vector3D> vertexPos
-    = { { -1.0f, -1.0f, 1.0f }, { -1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f, 1.0f }, { 1.0f, -1.0f, 1.0f },
-        { -1.0f, -1.0f, -1.0f }, { -1.0f, 1.0f, -1.0f }, { 1.0f, 1.0f, -1.0f }, { 1.0f, -1.0f, -1.0f } };
+inline constexpr std::array<Vector3D, 8> vertexPos
+    = { { { -1.0f, -1.0f, 1.0f }, { -1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f, 1.0f }, { 1.0f, -1.0f, 1.0f },
+          { -1.0f, -1.0f, -1.0f }, { -1.0f, 1.0f, -1.0f }, { 1.0f, 1.0f, -1.0f }, { 1.0f, -1.0f, -1.0f } } };
 
-inline static const std::vector<unsigned int> indices = { 
+inline constexpr std::array<unsigned int, 36> indices = {
     0, 1, 2, 2, 3, 0,
     4, 5, 6, 6, 7, 4,
     0, 1, 5, 5, 4, 0,
@@ -19,239 +52,100 @@ inline static const std::vector<unsigned int> indices = {
     1, 5, 6, 6, 2, 1,
     0, 4, 7, 7, 3, 0 };
 
- /* comment out to use single color per mesh
-    inline static const std::vector<Vertex> vertices = {
-    { { -1.0, -1.0, 1.0 },  { 1.0, 0.0, 0.0, 1.0 } },  // red
-    { { -1.0,  1.0, 1.0 },  { 0.0, 1.0, 0.0, 1.0 } },  // green
-    { {  1.0,  1.0, 1.0 },  { 0.0, 0.0, 1.0, 1.0 } },  // blue
-    { {  1.0, -1.0, 1.0 },  { 1.0, 0.0, 1.0, 1.0 } },  // magenta
-
-    { { -1.0, -1.0, -1.0 }, { 1.0, 0.0, 0.0, 1.0 } },  // red
-    { { -1.0,  1.0, -1.0 }, { 0.0, 1.0, 0.0, 1.0 } },  // green
-    { {  1.0,  1.0, -1.0 }, { 0.0, 0.0, 1.0, 1.0 } },  // blue
-    { {  1.0, -1.0, -1.0 }, { 1.0, 0.0, 1.0, 1.0 } }   // magenta
-};
-*/
-
 }
 
+/* cylinder along the x axis with radius 1 from x = -1 to x = 1, vertex 2k / 2k + 1 is the k-th point of the -x / +x
+ * rim, the caps are triangle fans */
 namespace cylinder {
 
-    inline static const std::vector<Vector3D> vertexPos{
-        {-1.0, 0.0, -1.0 },
-        { 1.0, -0.0, -1.0 },
-        {-1.0, -0.707107, -0.707107 },
-        {1.0, -0.707107, -0.707107 },
-        {-1.0, -1.0, 0.0 },
-        {1.0, -1.0, 0.0 },
-        {-1.0, -0.707107, 0.707107 },
-        {1.0, -0.707107, 0.707107 },
-        {-1.0, 0.0, 1.0 },
-        {1.0, -0.0, 1.0 },
-        {-1.0, 0.707107, 0.707107 },
-        {1.0, 0.707107, 0.707107 },
-        {-1.0, 1.0, 0.0 },
-        {1.0, 1.0, 0.0 },
-        {-1.0, 0.707107, -0.707107 },
-        {1.0, 0.707107, -0.707107 }
-    };
+template <unsigned int Segments>
+constexpr std::array<Vector3D, 2 * Segments> makeVertexPos()
+{
+    static_assert(Segments >= 3, "a cylinder needs at least 3 segments");
+    std::array<Vector3D, 2 * Segments> positions{};
+    for (unsigned int k = 0; k < Segments; k++) {
+        double angle = 2.0 * geometry::pi * k / Segments;
+        float y = static_cast<float>(-geometry::sin(angle));
+        float z = static_cast<float>(-geometry::cos(angle));
+        positions[2 * k] = Vector3D(-1.0f, y, z);
+        positions[2 * k + 1] = Vector3D(1.0f, y, z);
+    }
+    return positions;
+}
 
-    inline static const std::vector<unsigned int> indices = {
-        1, 2, 0, 3, 4, 2,
-        5, 6, 4, 7, 8, 6,
-        9, 10, 8, 11, 12, 10,
-        13, 9, 5, 13, 14, 12,
-        15, 0, 14, 6, 10, 14,
-        1, 3, 2, 3, 5, 4,
-        5, 7, 6, 7, 9, 8,
-        9, 11, 10, 11, 13, 12,
-        5, 3, 1, 1, 15, 13,
-        13, 11, 9, 9, 7, 5,
-        5, 1, 13, 13, 15, 14,
-        15, 1, 0, 14, 0, 2,
-        2, 4, 6, 6, 8, 10,
-        10, 12, 14, 14, 2, 6
-    };
+template <unsigned int Segments>
+constexpr std::array<unsigned int, 12 * Segments - 12> makeIndices()
+{
+    std::array<unsigned int, 12 * Segments - 12> indices{};
+    std::size_t i = 0;
+
+    /* side: two triangles per segment */
+    for (unsigned int k = 0; k < Segments; k++) {
+        unsigned int a = 2 * k, b = 2 * ((k + 1) % Segments);
+        indices[i++] = a + 1; indices[i++] = b;     indices[i++] = a;
+        indices[i++] = a + 1; indices[i++] = b + 1; indices[i++] = b;
+    }
+
+    /* caps */
+    for (unsigned int j = 0; j + 2 < Segments; j++) {
+        indices[i++] = 2 * (j + 2) + 1; indices[i++] = 2 * (j + 1) + 1; indices[i++] = 1;
+    }
+    for (unsigned int j = 0; j + 2 < Segments; j++) {
+        indices[i++] = 0; indices[i++] = 2 * (j + 1); indices[i++] = 2 * (j + 2);
+    }
+    return indices;
 }
 
+inline constexpr auto vertexPos = makeVertexPos<8>();
+inline constexpr auto indices = makeIndices<8>();
 
+}
 
 /* plane geometry */
 namespace quad {
 
-inline static const std::vector<Vector3D> vertexPos
-    = { { -1.0f, 0.0f, -1.0f }, { -1.0f, 0.0f, 1.0f }, { 1.0f, 0.0f, 1.0f }, { 1.0f, 0.0f, -1.0f } };
+inline constexpr std::array<Vector3D, 4> vertexPos
+    = { { { -1.0f, 0.0f, -1.0f }, { -1.0f, 0.0f, 1.0f }, { 1.0f, 0.0f, 1.0f }, { 1.0f, 0.0f, -1.0f } } };
 
-inline static const std::vector<unsigned int> indices = { 0, 1, 2, 2, 3, 0 };
+inline constexpr std::array<unsigned int, 6> indices = { 0, 1, 2, 2, 3, 0 };
 
 }
 
-/* grid geometry */
-namespace grid 
+/* grid geometry: Cells x Cells quads in the xz plane from -halfSize to halfSize, row major starting at
+ * (-halfSize, 0, halfSize) */
+namespace grid {
+
+template <unsigned int Cells>
+constexpr std::array<Vector3D, (Cells + 1) * (Cells + 1)> makeVertexPos(float halfSize)
 {
-    inline static const std::vector<Vector3D> vertexPos = { 
-        { -20, 0, 20 }, { -16, 0, 20 }, { -12, 0, 20 }, { -8, 0, 20 }, { -4, 0, 20 }, { 0, 0, 20 }, { 4, 0, 20 }, { 8, 0, 20 }, 
-        { 12, 0, 20 }, { 16, 0, 20 }, { 20, 0, 20 }, { -20, 0, 16 }, { -16, 0, 16 }, { -12, 0, 16 }, { -8, 0, 16 }, { -4, 0, 16 }, 
-        { 0, 0, 16 }, { 4, 0, 16 }, { 8, 0, 16 }, { 12, 0, 16 }, { 16, 0, 16 }, { 20, 0, 16 }, { -20, 0, 12 }, { -16, 0, 12 }, 
-        { -12, 0, 12 }, { -8, 0, 12 }, { -4, 0, 12 }, { 0, 0, 12 }, { 4, 0, 12 }, { 8, 0, 12 }, { 12, 0, 12 }, { 16, 0, 12 }, 
-        { 20, 0, 12 }, { -20, 0, 8 }, { -16, 0, 8 }, { -12, 0, 8 }, { -8, 0, 8 }, { -4, 0, 8 }, { 0, 0, 8 }, { 4, 0, 8 }, 
-        { 8, 0, 8 }, { 12, 0, 8 }, { 16, 0, 8 }, { 20, 0, 8 }, { -20, 0, 4 }, { -16, 0, 4 }, { -12, 0, 4 }, { -8, 0, 4 }, 
-        { -4, 0, 4 }, { 0, 0, 4 }, { 4, 0, 4 }, { 8, 0, 4 }, { 12, 0, 4 }, { 16, 0, 4 }, { 20, 0, 4 }, { -20, 0, 0 }, 
-        { -16, 0, 0 }, { -12, 0, 0 }, { -8, 0, 0 }, { -4, 0, 0 }, { 0, 0, 0 }, { 4, 0, 0 }, { 8, 0, 0 }, { 12, 0, 0 }, 
-        { 16, 0, 0 }, { 20, 0, 0 }, { -20, 0, -4 }, { -16, 0, -4 }, { -12, 0, -4 }, { -8, 0, -4 }, { -4, 0, -4 }, { 0, 0, -4 }, 
-        { 4, 0, -4 }, { 8, 0, -4 }, { 12, 0, -4 }, { 16, 0, -4 }, { 20, 0, -4 }, { -20, 0, -8 }, { -16, 0, -8 }, { -12, 0, -8 }, 
-        { -8, 0, -8 }, { -4, 0, -8 }, { 0, 0, -8 }, { 4, 0, -8 }, { 8, 0, -8 }, { 12, 0, -8 }, { 16, 0, -8 }, { 20, 0, -8 },
-        { -20, 0, -12 }, { -16, 0, -12 }, { -12, 0, -12 }, { -8, 0, -12 }, { -4, 0, -12 }, { 0, 0, -12 }, { 4, 0, -12 }, { 8, 0, -12 }, 
-        { 12, 0, -12 }, { 16, 0, -12 }, { 20, 0, -12 }, { -20, 0, -16 }, { -16, 0, -16 }, { -12, 0, -16 }, { -8, 0, -16 }, { -4, 0, -16 }, 
-        { 0, 0, -16 }, { 4, 0, -16 }, { 8, 0, -16 }, { 12, 0, -16 }, { 16, 0, -16 }, { 20, 0, -16 }, { -20, 0, -20 }, { -16, 0, -20 }, 
-        { -12, 0, -20 }, { -8, 0, -20 }, { -4, 0, -20 }, { 0, 0, -20 }, { 4, 0, -20 }, { 8, 0, -20 }, { 12, 0, -20 }, { 16, 0, -20 }, 
-        { 20, 0, -20 }, { -20, 0, 18 }, { -18, 0, 20 }, { -16, 0, 18 }, { -18, 0, 16 }, { -14, 0, 20 }, { -12, 0, 18 }, { -14, 0, 16 }, 
-        { -10, 0, 20 }, { -8, 0, 18 }, { -10, 0, 16 }, { -6, 0, 20 }, { -4, 0, 18 }, { -6, 0, 16 }, { -2, 0, 20 }, { 0, 0, 18 }, 
-        { -2, 0, 16 }, { 2, 0, 20 }, { 4, 0, 18 }, { 2, 0, 16 }, { 6, 0, 20 }, { 8, 0, 18 }, { 6, 0, 16 }, { 10, 0, 20 }, 
-        { 12, 0, 18 }, { 10, 0, 16 }, { 14, 0, 20 }, { 16, 0, 18 }, { 14, 0, 16 }, { 18, 0, 20 }, { 20, 0, 18 }, { 18, 0, 16 }, 
-        { -20, 0, 14 }, { -16, 0, 14 }, { -18, 0, 12 }, { -12, 0, 14 }, { -14, 0, 12 }, { -8, 0, 14 }, { -10, 0, 12 }, { -4, 0, 14 }, 
-        { -6, 0, 12 }, { 0, 0, 14 }, { -2, 0, 12 }, { 4, 0, 14 }, { 2, 0, 12 }, { 8, 0, 14 }, { 6, 0, 12 }, { 12, 0, 14 }, 
-        { 10, 0, 12 }, { 16, 0, 14 }, { 14, 0, 12 }, { 20, 0, 14 }, { 18, 0, 12 }, { -20, 0, 10 }, { -16, 0, 10 }, { -18, 0, 8 },
-        { -12, 0, 10 }, { -14, 0, 8 }, { -8, 0, 10 }, { -10, 0, 8 }, { -4, 0, 10 }, { -6, 0, 8 }, { 0, 0, 10 }, { -2, 0, 8 }, 
-        { 4, 0, 10 }, { 2, 0, 8 }, { 8, 0, 10 }, { 6, 0, 8 }, { 12, 0, 10 }, { 10, 0, 8 }, { 16, 0, 10 }, { 14, 0, 8 }, 
-        { 20, 0, 10 }, { 18, 0, 8 }, { -20, 0, 6 }, { -16, 0, 6 }, { -18, 0, 4 }, { -12, 0, 6 }, { -14, 0, 4 }, { -8, 0, 6 }, 
-        { -10, 0, 4 }, { -4, 0, 6 }, { -6, 0, 4 }, { 0, 0, 6 }, { -2, 0, 4 }, { 4, 0, 6 }, { 2, 0, 4 }, { 8, 0, 6 }, 
-        { 6, 0, 4 }, { 12, 0, 6 }, { 10, 0, 4 }, { 16, 0, 6 }, { 14, 0, 4 }, { 20, 0, 6 }, { 18, 0, 4 }, { -20, 0, 2 }, 
-        { -16, 0, 2 }, { -18, 0, 0 }, { -12, 0, 2 }, { -14, 0, 0 }, { -8, 0, 2 }, { -10, 0, 0 }, { -4, 0, 2 }, { -6, 0, 0 }, 
-        { 0, 0, 2 }, { -2, 0, 0 }, { 4, 0, 2 }, { 2, 0, 0 }, { 8, 0, 2 }, { 6, 0, 0 }, { 12, 0, 2 }, { 10, 0, 0 },
-        { 16, 0, 2 }, { 14, 0, 0 }, { 20, 0, 2 }, { 18, 0, 0 }, { -20, 0, -2 }, { -16, 0, -2 }, { -18, 0, -4 }, { -12, 0, -2 }, 
-        { -14, 0, -4 }, { -8, 0, -2 }, { -10, 0, -4 }, { -4, 0, -2 }, { -6, 0, -4 }, { 0, 0, -2 }, { -2, 0, -4 }, { 4, 0, -2 }, 
-        { 2, 0, -4 }, { 8, 0, -2 }, { 6, 0, -4 }, { 12, 0, -2 }, { 10, 0, -4 }, { 16, 0, -2 }, { 14, 0, -4 }, { 20, 0, -2 }, 
-        { 18, 0, -4 }, { -20, 0, -6 }, { -16, 0, -6 }, { -18, 0, -8 }, { -12, 0, -6 }, { -14, 0, -8 }, { -8, 0, -6 }, { -10, 0, -8 }, 
-        { -4, 0, -6 }, { -6, 0, -8 }, { 0, 0, -6 }, { -2, 0, -8 }, { 4, 0, -6 }, { 2, 0, -8 }, { 8, 0, -6 }, { 6, 0, -8 }, 
-        { 12, 0, -6 }, { 10, 0, -8 }, { 16, 0, -6 }, { 14, 0, -8 }, { 20, 0, -6 }, { 18, 0, -8 }, { -20, 0, -10 }, { -16, 0, -10 },
-        { -18, 0, -12 }, { -12, 0, -10 }, { -14, 0, -12 }, { -8, 0, -10 }, { -10, 0, -12 }, { -4, 0, -10 }, { -6, 0, -12 }, { 0, 0, -10 }, 
-        { -2, 0, -12 }, { 4, 0, -10 }, { 2, 0, -12 }, { 8, 0, -10 }, { 6, 0, -12 }, { 12, 0, -10 }, { 10, 0, -12 }, { 16, 0, -10 }, 
-        { 14, 0, -12 }, { 20, 0, -10 }, { 18, 0, -12 }, { -20, 0, -14 }, { -16, 0, -14 }, { -18, 0, -16 }, { -12, 0, -14 }, { -14, 0, -16 }, 
-        { -8, 0, -14 }, { -10, 0, -16 }, { -4, 0, -14 }, { -6, 0, -16 }, { 0, 0, -14 }, { -2, 0, -16 }, { 4, 0, -14 }, { 2, 0, -16 }, 
-        { 8, 0, -14 }, { 6, 0, -16 }, { 12, 0, -14 }, { 10, 0, -16 }, { 16, 0, -14 }, { 14, 0, -16 }, { 20, 0, -14 }, { 18, 0, -16 },
-        { -20, 0, -18 }, { -16, 0, -18 }, { -18, 0, -20 }, { -12, 0, -18 }, { -14, 0, -20 }, { -8, 0, -18 }, { -10, 0, -20 }, { -4, 0, -18 }, 
-        { -6, 0, -20 }, { 0, 0, -18 }, { -2, 0, -20 }, { 4, 0, -18 }, { 2, 0, -20 }, { 8, 0, -18 }, { 6, 0, -20 }, { 12, 0, -18 }, 
-        { 10, 0, -20 }, { 16, 0, -18 }, { 14, 0, -20 }, { 20, 0, -18 }, { 18, 0, -20 }, { -18, 0, 18 }, { -14, 0, 18 }, { -10, 0, 18 }, 
-        { -6, 0, 18 }, { -2, 0, 18 }, { 2, 0, 18 }, { 6, 0, 18 }, { 10, 0, 18 }, { 14, 0, 18 }, { 18, 0, 18 }, { -18, 0, 14 },
-        { -14, 0, 14 }, { -10, 0, 14 }, { -6, 0, 14 }, { -2, 0, 14 }, { 2, 0, 14 }, { 6, 0, 14 }, { 10, 0, 14 }, { 14, 0, 14 }, 
-        { 18, 0, 14 }, { -18, 0, 10 }, { -14, 0, 10 }, { -10, 0, 10 }, { -6, 0, 10 }, { -2, 0, 10 }, { 2, 0, 10 }, { 6, 0, 10 },
-        { 10, 0, 10 }, { 14, 0, 10 }, { 18, 0, 10 }, { -18, 0, 6 }, { -14, 0, 6 }, { -10, 0, 6 }, { -6, 0, 6 }, { -2, 0, 6 }, 
-        { 2, 0, 6 }, { 6, 0, 6 }, { 10, 0, 6 }, { 14, 0, 6 }, { 18, 0, 6 }, { -18, 0, 2 }, { -14, 0, 2 }, { -10, 0, 2 }, 
-        { -6, 0, 2 }, { -2, 0, 2 }, { 2, 0, 2 }, { 6, 0, 2 }, { 10, 0, 2 }, { 14, 0, 2 }, { 18, 0, 2 }, { -18, 0, -2 }, 
-        { -14, 0, -2 }, { -10, 0, -2 }, { -6, 0, -2 }, { -2, 0, -2 }, { 2, 0, -2 }, { 6, 0, -2 }, { 10, 0, -2 }, { 14, 0, -2 }, 
-        { 18, 0, -2 }, { -18, 0, -6 }, { -14, 0, -6 }, { -10, 0, -6 }, { -6, 0, -6 }, { -2, 0, -6 }, { 2, 0, -6 }, { 6, 0, -6 },
-        { 10, 0, -6 }, { 14, 0, -6 }, { 18, 0, -6 }, { -18, 0, -10 }, { -14, 0, -10 }, { -10, 0, -10 }, { -6, 0, -10 }, { -2, 0, -10 }, 
-        { 2, 0, -10 }, { 6, 0, -10 }, { 10, 0, -10 }, { 14, 0, -10 }, { 18, 0, -10 }, { -18, 0, -14 }, { -14, 0, -14 }, { -10, 0, -14 }, 
-        { -6, 0, -14 }, { -2, 0, -14 }, { 2, 0, -14 }, { 6, 0, -14 }, { 10, 0, -14 }, { 14, 0, -14 }, { 18, 0, -14 }, { -18, 0, -18 }, 
-        { -14, 0, -18 }, { -10, 0, -18 }, { -6, 0, -18 }, { -2, 0, -18 }, { 2, 0, -18 }, { 6, 0, -18 }, { 10, 0, -18 }, { 14, 0, -18 },
-        { 18, 0, -18 } 
-    };
+    std::array<Vector3D, (Cells + 1) * (Cells + 1)> positions{};
+    float step = 2.0f * halfSize / Cells;
+    for (unsigned int row = 0; row <= Cells; row++) {
+        for (unsigned int col = 0; col <= Cells; col++) {
+            positions[row * (Cells + 1) + col] = Vector3D(-halfSize + col * step, 0.0f, halfSize - row * step);
+        }
+    }
+    return positions;
+}
+
+template <unsigned int Cells>
+constexpr std::array<unsigned int, 6 * Cells * Cells> makeIndices()
+{
+    std::array<unsigned int, 6 * Cells * Cells> indices{};
+    std::size_t i = 0;
+    for (unsigned int row = 0; row < Cells; row++) {
+        for (unsigned int col = 0; col < Cells; col++) {
+            unsigned int v00 = row * (Cells + 1) + col, v01 = v00 + 1;
+            unsigned int v10 = v00 + Cells + 1, v11 = v10 + 1;
+            /* counter-clockwise seen from above (+y) */
+            indices[i++] = v00; indices[i++] = v01; indices[i++] = v11;
+            indices[i++] = v00; indices[i++] = v11; indices[i++] = v10;
+        }
+    }
+    return indices;
+}
 
-inline static const std::vector<unsigned int> indices = { 1, 341, 122, 2, 342, 125, 3, 343, 128, 4, 344, 131, 5, 345,
-    134, 6, 346, 137, 7, 347, 140, 8, 348, 143, 9, 349, 146, 10, 350, 149, 12, 351, 124, 13, 352, 127, 14, 353, 130, 15,
-    354, 133, 16, 355, 136, 17, 356, 139, 18, 357, 142, 19, 358, 145, 20, 359, 148, 21, 360, 151, 23, 361, 154, 24, 362,
-    156, 25, 363, 158, 26, 364, 160, 27, 365, 162, 28, 366, 164, 29, 367, 166, 30, 368, 168, 31, 369, 170, 32, 370, 172,
-    34, 371, 175, 35, 372, 177, 36, 373, 179, 37, 374, 181, 38, 375, 183, 39, 376, 185, 40, 377, 187, 41, 378, 189, 42,
-    379, 191, 43, 380, 193, 45, 381, 196, 46, 382, 198, 47, 383, 200, 48, 384, 202, 49, 385, 204, 50, 386, 206, 51, 387,
-    208, 52, 388, 210, 53, 389, 212, 54, 390, 214, 56, 391, 217, 57, 392, 219, 58, 393, 221, 59, 394, 223, 60, 395, 225,
-    61, 396, 227, 62, 397, 229, 63, 398, 231, 64, 399, 233, 65, 400, 235, 67, 401, 238, 68, 402, 240, 69, 403, 242, 70,
-    404, 244, 71, 405, 246, 72, 406, 248, 73, 407, 250, 74, 408, 252, 75, 409, 254, 76, 410, 256, 78, 411, 259, 79, 412,
-    261, 80, 413, 263, 81, 414, 265, 82, 415, 267, 83, 416, 269, 84, 417, 271, 85, 418, 273, 86, 419, 275, 87, 420, 277,
-    89, 421, 280, 90, 422, 282, 91, 423, 284, 92, 424, 286, 93, 425, 288, 94, 426, 290, 95, 427, 292, 96, 428, 294, 97,
-    429, 296, 98, 430, 298, 100, 431, 301, 101, 432, 303, 102, 433, 305, 103, 434, 307, 104, 435, 309, 105, 436, 311,
-    106, 437, 313, 107, 438, 315, 108, 439, 317, 109, 440, 319, 1, 123, 341, 2, 126, 342, 3, 129, 343, 4, 132, 344, 5,
-    135, 345, 6, 138, 346, 7, 141, 347, 8, 144, 348, 9, 147, 349, 10, 150, 350, 12, 153, 351, 13, 155, 352, 14, 157,
-    353, 15, 159, 354, 16, 161, 355, 17, 163, 356, 18, 165, 357, 19, 167, 358, 20, 169, 359, 21, 171, 360, 23, 174, 361,
-    24, 176, 362, 25, 178, 363, 26, 180, 364, 27, 182, 365, 28, 184, 366, 29, 186, 367, 30, 188, 368, 31, 190, 369, 32,
-    192, 370, 34, 195, 371, 35, 197, 372, 36, 199, 373, 37, 201, 374, 38, 203, 375, 39, 205, 376, 40, 207, 377, 41, 209,
-    378, 42, 211, 379, 43, 213, 380, 45, 216, 381, 46, 218, 382, 47, 220, 383, 48, 222, 384, 49, 224, 385, 50, 226, 386,
-    51, 228, 387, 52, 230, 388, 53, 232, 389, 54, 234, 390, 56, 237, 391, 57, 239, 392, 58, 241, 393, 59, 243, 394, 60,
-    245, 395, 61, 247, 396, 62, 249, 397, 63, 251, 398, 64, 253, 399, 65, 255, 400, 67, 258, 401, 68, 260, 402, 69, 262,
-    403, 70, 264, 404, 71, 266, 405, 72, 268, 406, 73, 270, 407, 74, 272, 408, 75, 274, 409, 76, 276, 410, 78, 279, 411,
-    79, 281, 412, 80, 283, 413, 81, 285, 414, 82, 287, 415, 83, 289, 416, 84, 291, 417, 85, 293, 418, 86, 295, 419, 87,
-    297, 420, 89, 300, 421, 90, 302, 422, 91, 304, 423, 92, 306, 424, 93, 308, 425, 94, 310, 426, 95, 312, 427, 96, 314,
-    428, 97, 316, 429, 98, 318, 430, 100, 321, 431, 101, 323, 432, 102, 325, 433, 103, 327, 434, 104, 329, 435, 105,
-    331, 436, 106, 333, 437, 107, 335, 438, 108, 337, 439, 109, 339, 440, 440, 340, 119, 440, 339, 340, 339, 120, 340,
-    439, 338, 118, 439, 337, 338, 337, 119, 338, 438, 336, 117, 438, 335, 336, 335, 118, 336, 437, 334, 116, 437, 333,
-    334, 333, 117, 334, 436, 332, 115, 436, 331, 332, 331, 116, 332, 435, 330, 114, 435, 329, 330, 329, 115, 330, 434,
-    328, 113, 434, 327, 328, 327, 114, 328, 433, 326, 112, 433, 325, 326, 325, 113, 326, 432, 324, 111, 432, 323, 324,
-    323, 112, 324, 431, 322, 110, 431, 321, 322, 321, 111, 322, 430, 319, 108, 430, 318, 319, 318, 109, 319, 429, 317,
-    107, 429, 316, 317, 316, 108, 317, 428, 315, 106, 428, 314, 315, 314, 107, 315, 427, 313, 105, 427, 312, 313, 312,
-    106, 313, 426, 311, 104, 426, 310, 311, 310, 105, 311, 425, 309, 103, 425, 308, 309, 308, 104, 309, 424, 307, 102,
-    424, 306, 307, 306, 103, 307, 423, 305, 101, 423, 304, 305, 304, 102, 305, 422, 303, 100, 422, 302, 303, 302, 101,
-    303, 421, 301, 99, 421, 300, 301, 300, 100, 301, 420, 298, 97, 420, 297, 298, 297, 98, 298, 419, 296, 96, 419, 295,
-    296, 295, 97, 296, 418, 294, 95, 418, 293, 294, 293, 96, 294, 417, 292, 94, 417, 291, 292, 291, 95, 292, 416, 290,
-    93, 416, 289, 290, 289, 94, 290, 415, 288, 92, 415, 287, 288, 287, 93, 288, 414, 286, 91, 414, 285, 286, 285, 92,
-    286, 413, 284, 90, 413, 283, 284, 283, 91, 284, 412, 282, 89, 412, 281, 282, 281, 90, 282, 411, 280, 88, 411, 279,
-    280, 279, 89, 280, 410, 277, 86, 410, 276, 277, 276, 87, 277, 409, 275, 85, 409, 274, 275, 274, 86, 275, 408, 273,
-    84, 408, 272, 273, 272, 85, 273, 407, 271, 83, 407, 270, 271, 270, 84, 271, 406, 269, 82, 406, 268, 269, 268, 83,
-    269, 405, 267, 81, 405, 266, 267, 266, 82, 267, 404, 265, 80, 404, 264, 265, 264, 81, 265, 403, 263, 79, 403, 262,
-    263, 262, 80, 263, 402, 261, 78, 402, 260, 261, 260, 79, 261, 401, 259, 77, 401, 258, 259, 258, 78, 259, 400, 256,
-    75, 400, 255, 256, 255, 76, 256, 399, 254, 74, 399, 253, 254, 253, 75, 254, 398, 252, 73, 398, 251, 252, 251, 74,
-    252, 397, 250, 72, 397, 249, 250, 249, 73, 250, 396, 248, 71, 396, 247, 248, 247, 72, 248, 395, 246, 70, 395, 245,
-    246, 245, 71, 246, 394, 244, 69, 394, 243, 244, 243, 70, 244, 393, 242, 68, 393, 241, 242, 241, 69, 242, 392, 240,
-    67, 392, 239, 240, 239, 68, 240, 391, 238, 66, 391, 237, 238, 237, 67, 238, 390, 235, 64, 390, 234, 235, 234, 65,
-    235, 389, 233, 63, 389, 232, 233, 232, 64, 233, 388, 231, 62, 388, 230, 231, 230, 63, 231, 387, 229, 61, 387, 228,
-    229, 228, 62, 229, 386, 227, 60, 386, 226, 227, 226, 61, 227, 385, 225, 59, 385, 224, 225, 224, 60, 225, 384, 223,
-    58, 384, 222, 223, 222, 59, 223, 383, 221, 57, 383, 220, 221, 220, 58, 221, 382, 219, 56, 382, 218, 219, 218, 57,
-    219, 381, 217, 55, 381, 216, 217, 216, 56, 217, 380, 214, 53, 380, 213, 214, 213, 54, 214, 379, 212, 52, 379, 211,
-    212, 211, 53, 212, 378, 210, 51, 378, 209, 210, 209, 52, 210, 377, 208, 50, 377, 207, 208, 207, 51, 208, 376, 206,
-    49, 376, 205, 206, 205, 50, 206, 375, 204, 48, 375, 203, 204, 203, 49, 204, 374, 202, 47, 374, 201, 202, 201, 48,
-    202, 373, 200, 46, 373, 199, 200, 199, 47, 200, 372, 198, 45, 372, 197, 198, 197, 46, 198, 371, 196, 44, 371, 195,
-    196, 195, 45, 196, 370, 193, 42, 370, 192, 193, 192, 43, 193, 369, 191, 41, 369, 190, 191, 190, 42, 191, 368, 189,
-    40, 368, 188, 189, 188, 41, 189, 367, 187, 39, 367, 186, 187, 186, 40, 187, 366, 185, 38, 366, 184, 185, 184, 39,
-    185, 365, 183, 37, 365, 182, 183, 182, 38, 183, 364, 181, 36, 364, 180, 181, 180, 37, 181, 363, 179, 35, 363, 178,
-    179, 178, 36, 179, 362, 177, 34, 362, 176, 177, 176, 35, 177, 361, 175, 33, 361, 174, 175, 174, 34, 175, 360, 172,
-    31, 360, 171, 172, 171, 32, 172, 359, 170, 30, 359, 169, 170, 169, 31, 170, 358, 168, 29, 358, 167, 168, 167, 30,
-    168, 357, 166, 28, 357, 165, 166, 165, 29, 166, 356, 164, 27, 356, 163, 164, 163, 28, 164, 355, 162, 26, 355, 161,
-    162, 161, 27, 162, 354, 160, 25, 354, 159, 160, 159, 26, 160, 353, 158, 24, 353, 157, 158, 157, 25, 158, 352, 156,
-    23, 352, 155, 156, 155, 24, 156, 351, 154, 22, 351, 153, 154, 153, 23, 154, 350, 151, 20, 350, 150, 151, 150, 21,
-    151, 349, 148, 19, 349, 147, 148, 147, 20, 148, 348, 145, 18, 348, 144, 145, 144, 19, 145, 347, 142, 17, 347, 141,
-    142, 141, 18, 142, 346, 139, 16, 346, 138, 139, 138, 17, 139, 345, 136, 15, 345, 135, 136, 135, 16, 136, 344, 133,
-    14, 344, 132, 133, 132, 15, 133, 343, 130, 13, 343, 129, 130, 129, 14, 130, 342, 127, 12, 342, 126, 127, 126, 13,
-    127, 341, 124, 11, 341, 123, 124, 123, 12, 124, 319, 337, 108, 319, 440, 337, 440, 119, 337, 317, 335, 107, 317,
-    439, 335, 439, 118, 335, 315, 333, 106, 315, 438, 333, 438, 117, 333, 313, 331, 105, 313, 437, 331, 437, 116, 331,
-    311, 329, 104, 311, 436, 329, 436, 115, 329, 309, 327, 103, 309, 435, 327, 435, 114, 327, 307, 325, 102, 307, 434,
-    325, 434, 113, 325, 305, 323, 101, 305, 433, 323, 433, 112, 323, 303, 321, 100, 303, 432, 321, 432, 111, 321, 301,
-    320, 99, 301, 431, 320, 431, 110, 320, 298, 316, 97, 298, 430, 316, 430, 108, 316, 296, 314, 96, 296, 429, 314, 429,
-    107, 314, 294, 312, 95, 294, 428, 312, 428, 106, 312, 292, 310, 94, 292, 427, 310, 427, 105, 310, 290, 308, 93, 290,
-    426, 308, 426, 104, 308, 288, 306, 92, 288, 425, 306, 425, 103, 306, 286, 304, 91, 286, 424, 304, 424, 102, 304,
-    284, 302, 90, 284, 423, 302, 423, 101, 302, 282, 300, 89, 282, 422, 300, 422, 100, 300, 280, 299, 88, 280, 421, 299,
-    421, 99, 299, 277, 295, 86, 277, 420, 295, 420, 97, 295, 275, 293, 85, 275, 419, 293, 419, 96, 293, 273, 291, 84,
-    273, 418, 291, 418, 95, 291, 271, 289, 83, 271, 417, 289, 417, 94, 289, 269, 287, 82, 269, 416, 287, 416, 93, 287,
-    267, 285, 81, 267, 415, 285, 415, 92, 285, 265, 283, 80, 265, 414, 283, 414, 91, 283, 263, 281, 79, 263, 413, 281,
-    413, 90, 281, 261, 279, 78, 261, 412, 279, 412, 89, 279, 259, 278, 77, 259, 411, 278, 411, 88, 278, 256, 274, 75,
-    256, 410, 274, 410, 86, 274, 254, 272, 74, 254, 409, 272, 409, 85, 272, 252, 270, 73, 252, 408, 270, 408, 84, 270,
-    250, 268, 72, 250, 407, 268, 407, 83, 268, 248, 266, 71, 248, 406, 266, 406, 82, 266, 246, 264, 70, 246, 405, 264,
-    405, 81, 264, 244, 262, 69, 244, 404, 262, 404, 80, 262, 242, 260, 68, 242, 403, 260, 403, 79, 260, 240, 258, 67,
-    240, 402, 258, 402, 78, 258, 238, 257, 66, 238, 401, 257, 401, 77, 257, 235, 253, 64, 235, 400, 253, 400, 75, 253,
-    233, 251, 63, 233, 399, 251, 399, 74, 251, 231, 249, 62, 231, 398, 249, 398, 73, 249, 229, 247, 61, 229, 397, 247,
-    397, 72, 247, 227, 245, 60, 227, 396, 245, 396, 71, 245, 225, 243, 59, 225, 395, 243, 395, 70, 243, 223, 241, 58,
-    223, 394, 241, 394, 69, 241, 221, 239, 57, 221, 393, 239, 393, 68, 239, 219, 237, 56, 219, 392, 237, 392, 67, 237,
-    217, 236, 55, 217, 391, 236, 391, 66, 236, 214, 232, 53, 214, 390, 232, 390, 64, 232, 212, 230, 52, 212, 389, 230,
-    389, 63, 230, 210, 228, 51, 210, 388, 228, 388, 62, 228, 208, 226, 50, 208, 387, 226, 387, 61, 226, 206, 224, 49,
-    206, 386, 224, 386, 60, 224, 204, 222, 48, 204, 385, 222, 385, 59, 222, 202, 220, 47, 202, 384, 220, 384, 58, 220,
-    200, 218, 46, 200, 383, 218, 383, 57, 218, 198, 216, 45, 198, 382, 216, 382, 56, 216, 196, 215, 44, 196, 381, 215,
-    381, 55, 215, 193, 211, 42, 193, 380, 211, 380, 53, 211, 191, 209, 41, 191, 379, 209, 379, 52, 209, 189, 207, 40,
-    189, 378, 207, 378, 51, 207, 187, 205, 39, 187, 377, 205, 377, 50, 205, 185, 203, 38, 185, 376, 203, 376, 49, 203,
-    183, 201, 37, 183, 375, 201, 375, 48, 201, 181, 199, 36, 181, 374, 199, 374, 47, 199, 179, 197, 35, 179, 373, 197,
-    373, 46, 197, 177, 195, 34, 177, 372, 195, 372, 45, 195, 175, 194, 33, 175, 371, 194, 371, 44, 194, 172, 190, 31,
-    172, 370, 190, 370, 42, 190, 170, 188, 30, 170, 369, 188, 369, 41, 188, 168, 186, 29, 168, 368, 186, 368, 40, 186,
-    166, 184, 28, 166, 367, 184, 367, 39, 184, 164, 182, 27, 164, 366, 182, 366, 38, 182, 162, 180, 26, 162, 365, 180,
-    365, 37, 180, 160, 178, 25, 160, 364, 178, 364, 36, 178, 158, 176, 24, 158, 363, 176, 363, 35, 176, 156, 174, 23,
-    156, 362, 174, 362, 34, 174, 154, 173, 22, 154, 361, 173, 361, 33, 173, 151, 169, 20, 151, 360, 169, 360, 31, 169,
-    148, 167, 19, 148, 359, 167, 359, 30, 167, 145, 165, 18, 145, 358, 165, 358, 29, 165, 142, 163, 17, 142, 357, 163,
-    357, 28, 163, 139, 161, 16, 139, 356, 161, 356, 27, 161, 136, 159, 15, 136, 355, 159, 355, 26, 159, 133, 157, 14,
-    133, 354, 157, 354, 25, 157, 130, 155, 13, 130, 353, 155, 353, 24, 155, 127, 153, 12, 127, 352, 153, 352, 23, 153,
-    124, 152, 11, 124, 351, 152, 351, 22, 152, 149, 147, 9, 149, 350, 147, 350, 20, 147, 146, 144, 8, 146, 349, 144,
-    349, 19, 144, 143, 141, 7, 143, 348, 141, 348, 18, 141, 140, 138, 6, 140, 347, 138, 347, 17, 138, 137, 135, 5, 137,
-    346, 135, 346, 16, 135, 134, 132, 4, 134, 345, 132, 345, 15, 132, 131, 129, 3, 131, 344, 129, 344, 14, 129, 128,
-    126, 2, 128, 343, 126, 343, 13, 126, 125, 123, 1, 125, 342, 123, 342, 12, 123, 122, 121, 0, 122, 341, 121, 341, 11,
-    121 };
+inline constexpr auto vertexPos = makeVertexPos<20>(20.0f);
+inline constexpr auto indices = makeIndices<20>();
 
-    inline static const std::vector<Vector3D> colors = {
-        { 0.0f, 0.2f, 0.38f },
-        { 0.96f, 0.57f, 0.0f },
-    };
 }
@@ -0,0 +1,179 @@
+#include "inputlog.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+namespace detail
+{
+    constexpr char inputLogMagic[4] = {'A', '3', 'I', 'N'};
+    constexpr std::uint32_t inputLogVersion = 1;
+
+    unsigned int numValues(eInputEvent type)
+    {
+        return type == InputEventOrbit ? 3 : 1;
+    }
+
+    template <typename T>
+    void put(std::vector<std::uint8_t> &out, const T &value)
+    {
+        const std::uint8_t *bytes = reinterpret_cast<const std::uint8_t *>(&value);
+        out.insert(out.end(), bytes, bytes + sizeof(T));
+    }
+
+    template <typename T>
+    bool get(const std::vector<std::uint8_t> &in, std::size_t &at, T &value)
+    {
+        if(at + sizeof(T) > in.size())
+        {
+            return false;
+        }
+        std::memcpy(&value, in.data() + at, sizeof(T));
+        at += sizeof(T);
+        return true;
+    }
+
+    void putVarint(std::vector<std::uint8_t> &out, std::uint32_t value)
+    {
+        while (value >= 0x80) {
+            out.push_back(static_cast<std::uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<std::uint8_t>(value));
+    }
+
+    bool getVarint(const std::vector<std::uint8_t> &in, std::size_t &at, std::uint32_t &value)
+    {
+        value = 0;
+        for (unsigned int shift = 0; shift < 35; shift += 7) {
+            if(at >= in.size())
+            {
+                return false;
+            }
+            std::uint8_t byte = in[at++];
+            value |= static_cast<std::uint32_t>(byte & 0x7f) << shift;
+            if(!(byte & 0x80))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+void inputLogAdd(InputLog &log, std::uint32_t step, eInputEvent type, float a, float b, float c)
+{
+    InputEvent event;
+    event.step = step;
+    event.type = type;
+    event.values[0] = a;
+    event.values[1] = b;
+    event.values[2] = c;
+    log.events.push_back(event);
+}
+
+bool inputLogNext(InputLog &log, std::uint32_t step, InputEvent &event)
+{
+    if(log.cursor >= log.events.size() || log.events[log.cursor].step > step)
+    {
+        return false;
+    }
+    event = log.events[log.cursor++];
+    return true;
+}
+
+bool inputLogSave(const InputLog &log, const std::string &path)
+{
+    std::vector<std::uint8_t> out;
+    out.insert(out.end(), std::begin(detail::inputLogMagic), std::end(detail::inputLogMagic));
+    detail::put(out, detail::inputLogVersion);
+    detail::put(out, log.simRate);
+    detail::put(out, log.numSteps);
+    detail::putVarint(out, static_cast<std::uint32_t>(log.scene.size()));
+    out.insert(out.end(), log.scene.begin(), log.scene.end());
+    detail::putVarint(out, static_cast<std::uint32_t>(log.events.size()));
+
+    std::uint32_t step = 0;
+    for (const auto &event : log.events) {
+        detail::putVarint(out, event.step - step);
+        step = event.step;
+        out.push_back(event.type);
+        for (unsigned int i = 0; i < detail::numValues(event.type); i++) {
+            detail::put(out, event.values[i]);
+        }
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char *>(out.data()), out.size());
+    if(!file)
+    {
+        std::cerr << "[InputLog] Couldn't write " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool inputLogLoad(const std::string &path, InputLog &log)
+{
+    std::ifstream file(path, std::ios::binary);
+    if(!file.is_open())
+    {
+        std::cerr << "[InputLog] Couldn't open " << path << std::endl;
+        return false;
+    }
+    std::vector<std::uint8_t> in((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    std::size_t at = 0;
+    std::uint32_t version = 0, sceneSize = 0, numEvents = 0;
+    bool ok = in.size() >= sizeof(detail::inputLogMagic) && std::memcmp(in.data(), detail::inputLogMagic, sizeof(detail::inputLogMagic)) == 0;
+    at = sizeof(detail::inputLogMagic);
+    ok = ok && detail::get(in, at, version) && version == detail::inputLogVersion;
+    ok = ok && detail::get(in, at, log.simRate) && detail::get(in, at, log.numSteps);
+    ok = ok && detail::getVarint(in, at, sceneSize) && at + sceneSize <= in.size();
+    if(ok)
+    {
+        log.scene.assign(reinterpret_cast<const char *>(in.data()) + at, sceneSize);
+        at += sceneSize;
+    }
+    ok = ok && detail::getVarint(in, at, numEvents);
+
+    log.events.clear();
+    log.cursor = 0;
+    std::uint32_t step = 0;
+    for (std::uint32_t i = 0; ok && i < numEvents; i++) {
+        InputEvent event;
+        std::uint32_t delta = 0;
+        std::uint8_t type = 0;
+        ok = detail::getVarint(in, at, delta) && detail::get(in, at, type);
+        ok = ok && type >= InputEventButtons && type <= InputEventCameraMode;
+        if(!ok)
+        {
+            break;
+        }
+
+        step += delta;
+        event.step = step;
+        event.type = static_cast<eInputEvent>(type);
+        for (unsigned int v = 0; ok && v < detail::numValues(event.type); v++) {
+            ok = detail::get(in, at, event.values[v]);
+        }
+        log.events.push_back(event);
+    }
+
+    if(!ok)
+    {
+        std::cerr << "[InputLog] " << path << " is not a valid input log" << std::endl;
+    }
+    return ok;
+}
+
+std::uint64_t inputLogHash(const void *data, std::size_t size, std::uint64_t hash)
+{
+    const std::uint8_t *bytes = static_cast<const std::uint8_t *>(data);
+    for (std::size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/* input event types, the meaning of the values is up to the application */
+enum eInputEvent : std::uint8_t
+{
+    InputEventButtons = 1,      // values[0]: bit mask of pressed buttons
+    InputEventOrbit = 2,        // values[0..2]: camera orbit delta x, y and zoom
+    InputEventCameraMode = 3    // values[0]: camera mode
+};
+
+/* input event that takes effect before simulation step `step` */
+struct InputEvent
+{
+    std::uint32_t step = 0;
+    eInputEvent type = InputEventButtons;
+    float values[3] = {0.0f, 0.0f, 0.0f};
+};
+
+/* recorded input of a run, events are sorted by step */
+struct InputLog
+{
+    std::string scene;          // description of the scene setup, a replay only makes sense with the same one
+    double simRate = 60.0;      // simulation steps per second of the recording
+    std::uint32_t numSteps = 0; // length of the run in simulation steps
+    std::vector<InputEvent> events;
+
+    std::size_t cursor = 0;     // next event to replay
+};
+
+/**
+ * @brief Appends an event to the log (steps have to be non-decreasing).
+ *
+ * @param log Input log.
+ * @param step Simulation step before which the event takes effect.
+ * @param type Event type.
+ * @param a, b, c Event values (see eInputEvent).
+ */
+void inputLogAdd(InputLog& log, std::uint32_t step, eInputEvent type, float a, float b = 0.0f, float c = 0.0f);
+
+/**
+ * @brief Next event to replay if it takes effect before the given step, advances the cursor.
+ *
+ * @param log Input log.
+ * @param step Simulation step about to run (numSteps for the events after the last step).
+ * @param event Gets the event.
+ *
+ * @return False if there is no such event.
+ */
+bool inputLogNext(InputLog& log, std::uint32_t step, InputEvent& event);
+
+/**
+ * @brief Writes the log in a compact binary format: header, then per event the step delta as varint, the type and
+ * only the values the type uses.
+ *
+ * @param log Input log.
+ * @param path Output file.
+ *
+ * @return False if the file couldn't be written.
+ */
+bool inputLogSave(const InputLog& log, const std::string& path);
+
+/**
+ * @brief Reads a log written by inputLogSave(...).
+ *
+ * @param path Input file.
+ * @param log Gets the log, the cursor is at the first event.
+ *
+ * @return False if the file couldn't be read or isn't an input log.
+ */
+bool inputLogLoad(const std::string& path, InputLog& log);
+
+/**
+ * @brief 64 bit FNV-1a hash, chain calls by passing the previous result, e.g. to hash the final state of a replay.
+ *
+ * @param data Bytes to hash.
+ * @param size Number of bytes.
+ * @param hash Previous hash value.
+ *
+ * @return New hash value.
+ */
+std::uint64_t inputLogHash(const void* data, std::size_t size, std::uint64_t hash = 0xcbf29ce484222325ull);
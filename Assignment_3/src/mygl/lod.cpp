@@ -0,0 +1,65 @@
+#include "lod.h"
+
+#include <cmath>
+#include <limits>
+
+namespace detail
+{
+    bool sameMesh(const Mesh &a, const Mesh &b)
+    {
+        return a.vao == b.vao && a.firstIndex == b.firstIndex && a.baseVertex == b.baseVertex && a.size_ibo == b.size_ibo;
+    }
+}
+
+float lodCylinderError(unsigned int segments)
+{
+    return static_cast<float>((1.0 - std::cos(M_PI / segments)) / std::sqrt(2.0));
+}
+
+float lodProjectedRadius(const Camera &camera, const BoundingSphere &sphere)
+{
+    float distance = length(sphere.center - camera.position);
+    if(distance <= sphere.radius)
+    {
+        return std::numeric_limits<float>::max();
+    }
+    return sphere.radius * 0.5f * camera.height / (distance * std::tan(0.5f * camera.fov));
+}
+
+void lodSelect(const Camera &camera, const std::vector<MeshLod> &lods, float tolerancePixels, FrameVector<DrawItem> &items, LodStats &stats)
+{
+    for (auto &item : items) {
+        for (const auto &lod : lods) {
+            if(lod.levels.empty() || !detail::sameMesh(item.mesh, lod.source))
+            {
+                continue;
+            }
+
+            float radius = lodProjectedRadius(camera, boundsTransform(item.mesh, item.model));
+            std::size_t level = lod.levels.size() - 1;
+            for (std::size_t i = 0; i < lod.levels.size(); i++) {
+                if(lod.errors[i] * radius <= tolerancePixels)
+                {
+                    level = i;
+                    break;
+                }
+            }
+
+            stats.selected++;
+            stats.trianglesFull += lod.levels.back().size_ibo / 3;
+            stats.trianglesDrawn += lod.levels[level].size_ibo / 3;
+            item.mesh = lod.levels[level];
+            break;
+        }
+    }
+}
+
+void lodDelete(MeshBuffer &buffer, const MeshLod &lod)
+{
+    for (const auto &level : lod.levels) {
+        if(!detail::sameMesh(level, lod.source))
+        {
+            meshDelete(buffer, level);
+        }
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "camera.h"
+#include "culling.h"
+#include "mesh.h"
+#include "meshbuffer.h"
+
+#include <vector>
+
+/* levels of detail of a primitive: draw items that use the source mesh get the coarsest level whose error stays
+ * below the pixel tolerance on screen */
+struct MeshLod
+{
+    Mesh source;
+    std::vector<Mesh> levels;   // coarsest first, all with the same bounds as the source
+    std::vector<float> errors;  // largest distance of each level to the exact surface, relative to the bounding radius
+};
+
+struct LodStats
+{
+    unsigned int selected = 0;          // items that got a level assigned
+    unsigned long long trianglesFull = 0;
+    unsigned long long trianglesDrawn = 0;
+};
+
+/**
+ * @brief Relative error of a cylinder with the given number of segments, i.e. how far the middle of a side is inside
+ * the round surface, for a cylinder with rim radius 1 and the bounding radius sqrt(2) of cylinder::vertexPos.
+ *
+ * @param segments Number of segments around the axis.
+ *
+ * @return Error relative to the bounding radius.
+ */
+float lodCylinderError(unsigned int segments);
+
+/**
+ * @brief Radius of a sphere projected onto the screen.
+ *
+ * @param camera Camera (fov and height are used).
+ * @param sphere World space sphere.
+ *
+ * @return Radius in pixels, a very large value if the camera is inside the sphere.
+ */
+float lodProjectedRadius(const Camera& camera, const BoundingSphere& sphere);
+
+/**
+ * @brief Replaces the mesh of every item that uses the source mesh of a LOD chain by the level that fits its size on
+ * screen. Call after culling, so only visible items are looked at.
+ *
+ * @param camera Camera the items are drawn with.
+ * @param lods LOD chains.
+ * @param tolerancePixels Largest error on screen that is accepted.
+ * @param items Draw items.
+ * @param stats Statistics that get the selections added.
+ */
+void lodSelect(const Camera& camera, const std::vector<MeshLod>& lods, float tolerancePixels, FrameVector<DrawItem>& items, LodStats& stats);
+
+/**
+ * @brief Deletes the levels of a LOD chain. The source mesh is kept, it belongs to whoever created it.
+ *
+ * @param buffer Mesh buffer the levels were allocated from.
+ * @param lod LOD chain.
+ */
+void lodDelete(MeshBuffer& buffer, const MeshLod& lod);
@@ -1,5 +1,8 @@
 #include "mesh.h"
 
+#include <algorithm>
+#include <limits>
+
 Mesh meshCreate(const std::vector<Vertex> &vertices, const std::vector<unsigned int> &indices, GLenum vertexBufferUsage, GLenum indexBufferUsage)
 {
     GLuint vao = 0, vbo = 0, ebo = 0;
@@ -29,7 +32,10 @@ Mesh meshCreate(const std::vector<Vertex> &vertices, const std::vector<unsigned
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
-    return Mesh{vao, vbo, ebo, (unsigned int) vertices.size(), (unsigned int) indices.size()};
+    Mesh mesh{vao, vbo, ebo, (unsigned int) vertices.size(), (unsigned int) indices.size()};
+    meshComputeBounds(mesh, vertices);
+
+    return mesh;
 }
 
 Mesh meshCreate(const std::vector<Vector3D>& positions, const std::vector<unsigned int>& indices, const Vector4D& color, GLenum vertexBufferUsage, GLenum indexBufferUsage) {
@@ -65,11 +71,53 @@ Mesh meshCreate(const std::vector<Vector3D>& positions, const std::vector<unsign
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
-    return Mesh{vao, vbo, ebo, (unsigned int) vertices.size(), (unsigned int) indices.size()};
+    Mesh mesh{vao, vbo, ebo, (unsigned int) vertices.size(), (unsigned int) indices.size()};
+    meshComputeBounds(mesh, vertices);
+
+    return mesh;
+}
+
+void meshComputeBounds(Mesh &mesh, const std::vector<Vertex> &vertices)
+{
+    if(vertices.empty())
+    {
+        mesh.boundsMin = mesh.boundsMax = mesh.boundsCenter = {0.0f, 0.0f, 0.0f};
+        mesh.boundsRadius = 0.0f;
+        return;
+    }
+
+    Vector3D lo(std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+    Vector3D hi = -lo;
+    for (const auto &v : vertices) {
+        for (unsigned k=0; k<3; k++) {
+            lo[k] = std::min(lo[k], v.pos[k]);
+            hi[k] = std::max(hi[k], v.pos[k]);
+        }
+    }
+
+    mesh.boundsMin = lo;
+    mesh.boundsMax = hi;
+    mesh.boundsCenter = (lo + hi) * 0.5f;
+
+    float radius = 0.0f;
+    for (const auto &v : vertices) {
+        radius = std::max(radius, length(v.pos - mesh.boundsCenter));
+    }
+    mesh.boundsRadius = radius;
+}
+
+void meshDraw(const Mesh &mesh)
+{
+    glDrawElementsBaseVertex(GL_TRIANGLES, mesh.size_ibo, GL_UNSIGNED_INT, (void*) (mesh.firstIndex * sizeof(unsigned int)), mesh.baseVertex);
 }
 
 void meshDelete(const Mesh &mesh)
 {
+    if(mesh.shared)
+    {
+        return;
+    }
+
     glDeleteBuffers(1, &mesh.vbo);
     glDeleteBuffers(1, &mesh.ebo);
     glDeleteVertexArrays(1, &mesh.vao);
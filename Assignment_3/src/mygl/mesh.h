@@ -21,6 +21,17 @@ struct Mesh
 
     unsigned int size_vbo = 0;
     unsigned int size_ibo = 0;
+
+    /* location of the mesh data inside its buffers, only non-zero for meshes allocated from a MeshBuffer */
+    int baseVertex = 0;
+    unsigned int firstIndex = 0;
+    bool shared = false;
+
+    /* local bounding volumes (axis aligned box and sphere around its center) */
+    Vector3D boundsMin = Vector3D(0.0f, 0.0f, 0.0f);
+    Vector3D boundsMax = Vector3D(0.0f, 0.0f, 0.0f);
+    Vector3D boundsCenter = Vector3D(0.0f, 0.0f, 0.0f);
+    float boundsRadius = 0.0f;
 };
 
 /**
@@ -64,8 +75,25 @@ Mesh meshCreate(const std::vector<Vertex>& vertices, const std::vector<unsigned
  */
 Mesh meshCreate(const std::vector<Vector3D>& positions, const std::vector<unsigned int>& indices, const Vector4D& color, GLenum vertexBufferUsage, GLenum indexBufferUsage);
 
+/**
+ * @brief Computes the local bounding box and bounding sphere of a mesh from its vertex positions.
+ *
+ * @param mesh Mesh whose bounds get updated.
+ * @param vertices Vertex data of the mesh.
+ */
+void meshComputeBounds(Mesh& mesh, const std::vector<Vertex>& vertices);
+
+/**
+ * @brief Issue the draw call for a mesh. The vertex array object of the mesh has to be bound already, so that
+ * consecutive meshes of the same MeshBuffer can be drawn without rebinding.
+ *
+ * @param mesh Mesh to draw.
+ */
+void meshDraw(const Mesh& mesh);
+
 /**
  * @brief Cleanup and delete all OpenGL buffers of a mesh. Has to be called for each mesh after it is not used anymore.
+ * Meshes allocated from a MeshBuffer don't own their buffers, they are freed with meshDelete(MeshBuffer&, const Mesh&).
  *
  * @param mesh Mesh to delete.
  */
@@ -0,0 +1,220 @@
+#include "meshbuffer.h"
+
+#include <cstdio>
+#include <iostream>
+#include <stdexcept>
+
+namespace detail
+{
+    /* allocates the ranges of a mesh, throws if one of the buffers has no block large enough */
+    void allocateRanges(MeshBuffer &buffer, std::uint32_t numVertices, std::uint32_t numIndices, std::uint32_t &firstVertex, std::uint32_t &firstIndex)
+    {
+        if(!rangeAllocatorAlloc(buffer.vertexAllocator, numVertices, firstVertex))
+        {
+            firstVertex = ~0u;
+        }
+        else if(!rangeAllocatorAlloc(buffer.indexAllocator, numIndices, firstIndex))
+        {
+            rangeAllocatorFree(buffer.vertexAllocator, firstVertex);
+            firstVertex = ~0u;
+        }
+
+        if(firstVertex == ~0u)
+        {
+            std::cerr << "[MeshBuffer] Not enough space left for mesh with " << numVertices << " vertices and " << numIndices << " indices" << std::endl;
+            std::cerr.flush();
+            throw std::runtime_error("[MeshBuffer] Not enough space left for mesh");
+        }
+    }
+
+    void releaseFrees(MeshBuffer &buffer, const MeshBufferFrees &frees)
+    {
+        for (auto offset : frees.vertexOffsets) {
+            rangeAllocatorFree(buffer.vertexAllocator, offset);
+        }
+        for (auto offset : frees.indexOffsets) {
+            rangeAllocatorFree(buffer.indexAllocator, offset);
+        }
+    }
+}
+
+MeshBuffer meshBufferCreate(unsigned int maxVertices, unsigned int maxIndices)
+{
+    MeshBuffer buffer;
+    buffer.capacityVertices = maxVertices;
+    buffer.capacityIndices = maxIndices;
+    buffer.vertexAllocator = rangeAllocatorCreate(maxVertices);
+    buffer.indexAllocator = rangeAllocatorCreate(maxIndices);
+
+    glGenVertexArrays(1, &buffer.vao);
+    glGenBuffers(1, &buffer.vbo);
+    glGenBuffers(1, &buffer.ebo);
+
+    glBindVertexArray(buffer.vao);
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, buffer.vbo);
+        glBufferData(GL_ARRAY_BUFFER, maxVertices * sizeof(Vertex), nullptr, GL_STATIC_DRAW);
+        glCheckError();
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer.ebo);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, maxIndices * sizeof(unsigned int), nullptr, GL_STATIC_DRAW);
+        glCheckError();
+
+        glEnableVertexAttribArray(eDataIdx::Position);
+        glEnableVertexAttribArray(eDataIdx::Color);
+        glVertexAttribPointer(eDataIdx::Position,   3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*) offsetof(Vertex, pos));
+        glVertexAttribPointer(eDataIdx::Color,      4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*) offsetof(Vertex, color));
+        glCheckError();
+    }
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    return buffer;
+}
+
+Mesh meshBufferAdd(MeshBuffer &buffer, const std::vector<Vertex> &vertices, const std::vector<unsigned int> &indices)
+{
+    std::uint32_t firstVertex, firstIndex;
+    detail::allocateRanges(buffer, vertices.size(), indices.size(), firstVertex, firstIndex);
+
+    Mesh mesh{buffer.vao, buffer.vbo, buffer.ebo, (unsigned int) vertices.size(), (unsigned int) indices.size()};
+    mesh.baseVertex = static_cast<int>(firstVertex);
+    mesh.firstIndex = firstIndex;
+    mesh.shared = true;
+    meshComputeBounds(mesh, vertices);
+
+    /* the element buffer is part of the VAO state, so bind the VAO to upload the indices */
+    glBindVertexArray(buffer.vao);
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, buffer.vbo);
+        glBufferSubData(GL_ARRAY_BUFFER, firstVertex * sizeof(Vertex), vertices.size() * sizeof(Vertex), vertices.data());
+        glCheckError();
+
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, firstIndex * sizeof(unsigned int), indices.size() * sizeof(unsigned int), indices.data());
+        glCheckError();
+    }
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    return mesh;
+}
+
+Mesh meshBufferAdd(MeshBuffer &buffer, const std::vector<Vector3D> &positions, const std::vector<unsigned int> &indices, const Vector4D &color)
+{
+    std::vector<Vertex> vertices(positions.size());
+    for (unsigned i=0; i<vertices.size(); i++) {
+        vertices[i] = {positions[i], color};
+    }
+
+    return meshBufferAdd(buffer, vertices, indices);
+}
+
+std::vector<Mesh> meshBufferAddPack(MeshBuffer &buffer, const MeshPack &pack, const std::vector<int> &entries)
+{
+    /* one range per entry, so every mesh of the pack can be freed on its own */
+    std::vector<Mesh> meshes(entries.size());
+    for (std::size_t i = 0; i < entries.size(); i++) {
+        const MeshPackEntry &entry = pack.entries[entries[i]];
+        std::uint32_t firstVertex, firstIndex;
+        detail::allocateRanges(buffer, entry.numVertices, entry.numIndices, firstVertex, firstIndex);
+
+        Mesh &mesh = meshes[i];
+        mesh = {buffer.vao, buffer.vbo, buffer.ebo, entry.numVertices, entry.numIndices};
+        mesh.baseVertex = static_cast<int>(firstVertex);
+        mesh.firstIndex = firstIndex;
+        mesh.shared = true;
+        mesh.boundsMin = Vector3D(entry.boundsMin[0], entry.boundsMin[1], entry.boundsMin[2]);
+        mesh.boundsMax = Vector3D(entry.boundsMax[0], entry.boundsMax[1], entry.boundsMax[2]);
+        mesh.boundsCenter = Vector3D(entry.boundsCenter[0], entry.boundsCenter[1], entry.boundsCenter[2]);
+        mesh.boundsRadius = entry.boundsRadius;
+    }
+
+    /* indices in the pack are relative to the first vertex of their mesh, so the slices go in unchanged */
+    glBindVertexArray(buffer.vao);
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, buffer.vbo);
+        for (std::size_t i = 0; i < entries.size(); i++) {
+            const MeshPackEntry &entry = pack.entries[entries[i]];
+            glBufferSubData(GL_ARRAY_BUFFER, meshes[i].baseVertex * sizeof(Vertex), entry.numVertices * sizeof(Vertex),
+                            meshPackVertices(pack) + entry.firstVertex);
+            glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, meshes[i].firstIndex * sizeof(unsigned int), entry.numIndices * sizeof(unsigned int),
+                            meshPackIndices(pack) + entry.firstIndex);
+        }
+        glCheckError();
+    }
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    return meshes;
+}
+
+void meshBufferFree(MeshBuffer &buffer, const Mesh &mesh)
+{
+    buffer.frees.vertexOffsets.push_back(static_cast<std::uint32_t>(mesh.baseVertex));
+    buffer.frees.indexOffsets.push_back(mesh.firstIndex);
+}
+
+void meshDelete(MeshBuffer &buffer, const Mesh &mesh)
+{
+    if(mesh.shared)
+    {
+        meshBufferFree(buffer, mesh);
+    }
+    else
+    {
+        meshDelete(mesh);
+    }
+}
+
+void meshBufferEndFrame(MeshBuffer &buffer)
+{
+    if(!buffer.frees.vertexOffsets.empty())
+    {
+        buffer.frees.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        buffer.pendingFrees.push_back(std::move(buffer.frees));
+        buffer.frees = MeshBufferFrees();
+    }
+
+    /* fences signal in order, stop at the first frame that is still in flight */
+    while (!buffer.pendingFrees.empty()) {
+        MeshBufferFrees &oldest = buffer.pendingFrees.front();
+        GLenum status = glClientWaitSync(oldest.fence, 0, 0);
+        if(status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+        {
+            break;
+        }
+        glDeleteSync(oldest.fence);
+        detail::releaseFrees(buffer, oldest);
+        buffer.pendingFrees.pop_front();
+    }
+}
+
+std::string meshBufferSummary(const MeshBuffer &buffer)
+{
+    RangeAllocatorStats vertices = rangeAllocatorStats(buffer.vertexAllocator);
+    RangeAllocatorStats indices = rangeAllocatorStats(buffer.indexAllocator);
+    std::size_t pending = buffer.frees.vertexOffsets.size();
+    for (const auto &frees : buffer.pendingFrees) {
+        pending += frees.vertexOffsets.size();
+    }
+
+    char line[256];
+    std::snprintf(line, sizeof(line), "%u meshes, vertices %u of %u (%.1f%% fragmented), indices %u of %u (%.1f%% fragmented), %zu frees pending",
+                  vertices.allocations, vertices.used, vertices.capacity, 100.0f * vertices.fragmentation,
+                  indices.used, indices.capacity, 100.0f * indices.fragmentation, pending);
+    return line;
+}
+
+void meshBufferDelete(const MeshBuffer &buffer)
+{
+    for (const auto &frees : buffer.pendingFrees) {
+        glDeleteSync(frees.fence);
+    }
+    glDeleteBuffers(1, &buffer.vbo);
+    glDeleteBuffers(1, &buffer.ebo);
+    glDeleteVertexArrays(1, &buffer.vao);
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include "mesh.h"
+#include "meshpack.h"
+#include "rangeallocator.h"
+
+#include <array>
+#include <deque>
+#include <string>
+#include <vector>
+
+/* ranges of a freed mesh (vertex and index offsets), released once the GPU is done with the frame that freed it */
+struct MeshBufferFrees
+{
+    GLsync fence = nullptr;
+    std::vector<std::uint32_t> vertexOffsets;
+    std::vector<std::uint32_t> indexOffsets;
+};
+
+/* one vertex and one index buffer shared by many meshes with the Vertex layout, sub-allocated with TLSF so meshes
+ * can come and go without creating or deleting GL buffers */
+struct MeshBuffer
+{
+    GLuint vao = 0;
+    GLuint vbo = 0;
+    GLuint ebo = 0;
+
+    unsigned int capacityVertices = 0;
+    unsigned int capacityIndices = 0;
+    RangeAllocator vertexAllocator;
+    RangeAllocator indexAllocator;
+
+    MeshBufferFrees frees;                  // freed during the current frame
+    std::deque<MeshBufferFrees> pendingFrees; // older frames, oldest first
+};
+
+/**
+ * @brief Allocates a vertex and an index buffer of fixed size and a vertex array object that binds them. Meshes are
+ * added later with meshBufferAdd(...).
+ *
+ * @param maxVertices Number of vertices the buffer can hold.
+ * @param maxIndices Number of indices the buffer can hold.
+ *
+ * @return Initialized, empty mesh buffer.
+ */
+MeshBuffer meshBufferCreate(unsigned int maxVertices, unsigned int maxIndices);
+
+/**
+ * @brief Copies the mesh data into free ranges of the shared buffers. The returned mesh refers to the buffers of the
+ * MeshBuffer and stores where its data starts (baseVertex, firstIndex) and how many indices it has (size_ibo).
+ *
+ * @param buffer Mesh buffer to add the mesh to.
+ * @param vertices Data for each vertex of the mesh.
+ * @param indices List of indices that form polygons in the mesh (relative to the first vertex of the mesh).
+ *
+ * @return Mesh structure that can be drawn with meshDraw(...) while the buffer's VAO is bound.
+ *
+ * usage:
+ *
+ *   MeshBuffer buffer = meshBufferCreate(1 << 16, 1 << 18);
+ *   Mesh a = meshBufferAdd(buffer, vertex-data-a, index-data-a);
+ *   Mesh b = meshBufferAdd(buffer, vertex-data-b, index-data-b);
+ *   glBindVertexArray(buffer.vao);
+ *   meshDraw(a);
+ *   meshDraw(b);
+ *
+ */
+Mesh meshBufferAdd(MeshBuffer& buffer, const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices);
+
+/**
+ * @brief Same as above, but every vertex gets the same color.
+ *
+ * @param buffer Mesh buffer to add the mesh to.
+ * @param positions Position data for each vertex of the mesh.
+ * @param indices List of indices that form polygons in the mesh.
+ * @param color Color used for each of the vertices of this mesh.
+ *
+ * @return Mesh structure that can be drawn with meshDraw(...) while the buffer's VAO is bound.
+ */
+Mesh meshBufferAdd(MeshBuffer& buffer, const std::vector<Vector3D>& positions, const std::vector<unsigned int>& indices, const Vector4D& color);
+
+/**
+ * @brief Same as above for compile time geometry (see geometry.h).
+ */
+template <std::size_t NumPositions, std::size_t NumIndices>
+Mesh meshBufferAdd(MeshBuffer& buffer, const std::array<Vector3D, NumPositions>& positions, const std::array<unsigned int, NumIndices>& indices, const Vector4D& color)
+{
+    return meshBufferAdd(buffer, std::vector<Vector3D>(positions.begin(), positions.end()),
+                         std::vector<unsigned int>(indices.begin(), indices.end()), color);
+}
+
+/**
+ * @brief Adds meshes of a pack. Every mesh gets its own ranges (so it can be freed like any other mesh), its vertices
+ * and indices are copied straight from the file mapping into the shared buffers, the bounds come from the pack.
+ * Entries that aren't asked for are not uploaded.
+ *
+ * @param buffer Mesh buffer to add the meshes to.
+ * @param pack Opened mesh pack, can be closed afterwards.
+ * @param entries Indices of the entries to add (see meshPackFind(...)).
+ *
+ * @return Meshes in the order of the given entries.
+ */
+std::vector<Mesh> meshBufferAddPack(MeshBuffer& buffer, const MeshPack& pack, const std::vector<int>& entries);
+
+/**
+ * @brief Frees the ranges of a mesh. They are reused only after the GPU finished the frames that may still draw the
+ * mesh, see meshBufferEndFrame(...).
+ *
+ * @param buffer Mesh buffer the mesh was allocated from.
+ * @param mesh Mesh to free.
+ */
+void meshBufferFree(MeshBuffer& buffer, const Mesh& mesh);
+
+/**
+ * @brief Deletes a mesh wherever its data lives: meshes of the buffer are freed with meshBufferFree(...), meshes with
+ * their own OpenGL buffers are deleted with meshDelete(mesh).
+ *
+ * @param buffer Mesh buffer the mesh may have been allocated from.
+ * @param mesh Mesh to delete.
+ */
+void meshDelete(MeshBuffer& buffer, const Mesh& mesh);
+
+/**
+ * @brief Call once per frame after the draw calls: fences the frees of this frame and releases the ranges of older
+ * frames the GPU has finished (without waiting).
+ *
+ * @param buffer Mesh buffer.
+ */
+void meshBufferEndFrame(MeshBuffer& buffer);
+
+/**
+ * @brief Formats usage and fragmentation of the vertex and index ranges.
+ *
+ * @param buffer Mesh buffer.
+ *
+ * @return One line summary.
+ */
+std::string meshBufferSummary(const MeshBuffer& buffer);
+
+/**
+ * @brief Cleanup and delete the OpenGL buffers of a mesh buffer. All meshes added to it become invalid.
+ *
+ * @param buffer Mesh buffer to delete.
+ */
+void meshBufferDelete(const MeshBuffer& buffer);
@@ -0,0 +1,235 @@
+#include "meshpack.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace detail
+{
+    constexpr char meshPackMagic[4] = {'A', '3', 'M', 'P'};
+
+    std::uint64_t alignUp(std::uint64_t offset)
+    {
+        return (offset + MESH_PACK_ALIGNMENT - 1) / MESH_PACK_ALIGNMENT * MESH_PACK_ALIGNMENT;
+    }
+
+    bool mapFile(const std::string &path, MeshPack &pack)
+    {
+#ifdef _WIN32
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if(file == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+        LARGE_INTEGER size;
+        HANDLE mapping = GetFileSizeEx(file, &size) && size.QuadPart > 0 ? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+        CloseHandle(file);
+        if(!mapping)
+        {
+            return false;
+        }
+        void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if(!data)
+        {
+            CloseHandle(mapping);
+            return false;
+        }
+        pack.data = static_cast<const std::uint8_t *>(data);
+        pack.size = static_cast<std::size_t>(size.QuadPart);
+        pack.mapping = mapping;
+#else
+        int file = open(path.c_str(), O_RDONLY);
+        if(file < 0)
+        {
+            return false;
+        }
+        struct stat info;
+        void *data = MAP_FAILED;
+        if(fstat(file, &info) == 0 && info.st_size > 0)
+        {
+            data = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+        }
+        close(file);
+        if(data == MAP_FAILED)
+        {
+            return false;
+        }
+        pack.data = static_cast<const std::uint8_t *>(data);
+        pack.size = static_cast<std::size_t>(info.st_size);
+#endif
+        return true;
+    }
+
+    bool validate(const MeshPack &pack)
+    {
+        if(pack.size < sizeof(MeshPackHeader))
+        {
+            return false;
+        }
+        const MeshPackHeader &header = *reinterpret_cast<const MeshPackHeader *>(pack.data);
+        if(std::memcmp(header.magic, meshPackMagic, sizeof(meshPackMagic)) != 0 || header.version != MESH_PACK_VERSION
+           || header.vertexStride != sizeof(Vertex))
+        {
+            return false;
+        }
+
+        std::uint64_t entriesEnd = sizeof(MeshPackHeader) + std::uint64_t(header.numMeshes) * sizeof(MeshPackEntry);
+        if(entriesEnd > pack.size || header.vertexOffset % MESH_PACK_ALIGNMENT != 0 || header.indexOffset % MESH_PACK_ALIGNMENT != 0
+           || header.vertexOffset + header.vertexBytes > pack.size || header.indexOffset + header.indexBytes > pack.size)
+        {
+            return false;
+        }
+
+        std::uint64_t numVertices = header.vertexBytes / sizeof(Vertex);
+        std::uint64_t numIndices = header.indexBytes / sizeof(unsigned int);
+        const MeshPackEntry *entries = reinterpret_cast<const MeshPackEntry *>(pack.data + sizeof(MeshPackHeader));
+        const unsigned int *indices = reinterpret_cast<const unsigned int *>(pack.data + header.indexOffset);
+        for (std::uint32_t i = 0; i < header.numMeshes; i++) {
+            const MeshPackEntry &entry = entries[i];
+            if(entry.name[sizeof(entry.name) - 1] != '\0'
+               || std::uint64_t(entry.firstVertex) + entry.numVertices > numVertices
+               || std::uint64_t(entry.firstIndex) + entry.numIndices > numIndices)
+            {
+                return false;
+            }
+
+            /* an index outside of its mesh would read the vertices of another mesh in the shared buffer */
+            for (std::uint32_t k = 0; k < entry.numIndices; k++) {
+                if(indices[entry.firstIndex + k] >= entry.numVertices)
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+}
+
+bool meshPackOpen(const std::string &path, MeshPack &pack)
+{
+    pack = MeshPack();
+    if(!detail::mapFile(path, pack))
+    {
+        std::cerr << "[MeshPack] Couldn't map " << path << std::endl;
+        return false;
+    }
+    if(!detail::validate(pack))
+    {
+        std::cerr << "[MeshPack] " << path << " is not a valid mesh pack of version " << MESH_PACK_VERSION << ", bake it again" << std::endl;
+        meshPackClose(pack);
+        return false;
+    }
+
+    pack.header = reinterpret_cast<const MeshPackHeader *>(pack.data);
+    pack.entries = reinterpret_cast<const MeshPackEntry *>(pack.data + sizeof(MeshPackHeader));
+    return true;
+}
+
+int meshPackFind(const MeshPack &pack, const std::string &name)
+{
+    for (std::uint32_t i = 0; i < pack.header->numMeshes; i++) {
+        if(name == pack.entries[i].name)
+        {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+const Vertex *meshPackVertices(const MeshPack &pack)
+{
+    return reinterpret_cast<const Vertex *>(pack.data + pack.header->vertexOffset);
+}
+
+const unsigned int *meshPackIndices(const MeshPack &pack)
+{
+    return reinterpret_cast<const unsigned int *>(pack.data + pack.header->indexOffset);
+}
+
+void meshPackClose(MeshPack &pack)
+{
+    if(pack.data)
+    {
+#ifdef _WIN32
+        UnmapViewOfFile(pack.data);
+        CloseHandle(static_cast<HANDLE>(pack.mapping));
+#else
+        munmap(const_cast<std::uint8_t *>(pack.data), pack.size);
+#endif
+    }
+    pack = MeshPack();
+}
+
+bool meshPackWrite(const std::string &path, const std::vector<MeshPackSource> &meshes)
+{
+    MeshPackHeader header = {};
+    std::memcpy(header.magic, detail::meshPackMagic, sizeof(header.magic));
+    header.version = MESH_PACK_VERSION;
+    header.numMeshes = static_cast<std::uint32_t>(meshes.size());
+    header.vertexStride = sizeof(Vertex);
+
+    std::vector<MeshPackEntry> entries(meshes.size());
+    std::uint32_t numVertices = 0, numIndices = 0;
+    for (std::size_t i = 0; i < meshes.size(); i++) {
+        MeshPackEntry &entry = entries[i];
+        std::memset(&entry, 0, sizeof(entry));
+        std::strncpy(entry.name, meshes[i].name.c_str(), sizeof(entry.name) - 1);
+        entry.firstVertex = numVertices;
+        entry.numVertices = static_cast<std::uint32_t>(meshes[i].vertices.size());
+        entry.firstIndex = numIndices;
+        entry.numIndices = static_cast<std::uint32_t>(meshes[i].indices.size());
+        numVertices += entry.numVertices;
+        numIndices += entry.numIndices;
+
+        Mesh bounds;
+        meshComputeBounds(bounds, meshes[i].vertices);
+        for (unsigned int k = 0; k < 3; k++) {
+            entry.boundsMin[k] = bounds.boundsMin[k];
+            entry.boundsMax[k] = bounds.boundsMax[k];
+            entry.boundsCenter[k] = bounds.boundsCenter[k];
+        }
+        entry.boundsRadius = bounds.boundsRadius;
+    }
+
+    header.vertexOffset = detail::alignUp(sizeof(MeshPackHeader) + entries.size() * sizeof(MeshPackEntry));
+    header.vertexBytes = std::uint64_t(numVertices) * sizeof(Vertex);
+    header.indexOffset = detail::alignUp(header.vertexOffset + header.vertexBytes);
+    header.indexBytes = std::uint64_t(numIndices) * sizeof(unsigned int);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    auto padTo = [&file](std::uint64_t offset) {
+        static const char zeros[MESH_PACK_ALIGNMENT] = {};
+        std::uint64_t at = static_cast<std::uint64_t>(file.tellp());
+        file.write(zeros, static_cast<std::streamsize>(offset - at));
+    };
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(entries.data()), entries.size() * sizeof(MeshPackEntry));
+    padTo(header.vertexOffset);
+    for (const auto &mesh : meshes) {
+        file.write(reinterpret_cast<const char *>(mesh.vertices.data()), mesh.vertices.size() * sizeof(Vertex));
+    }
+    padTo(header.indexOffset);
+    for (const auto &mesh : meshes) {
+        file.write(reinterpret_cast<const char *>(mesh.indices.data()), mesh.indices.size() * sizeof(unsigned int));
+    }
+
+    if(!file)
+    {
+        std::cerr << "[MeshPack] Couldn't write " << path << std::endl;
+        return false;
+    }
+    return true;
+}
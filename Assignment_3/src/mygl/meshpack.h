@@ -0,0 +1,102 @@
+#pragma once
+
+#include "mesh.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/* version of the binary layout below, packs of another version are rejected and have to be baked again */
+constexpr std::uint32_t MESH_PACK_VERSION = 1;
+/* alignment of the vertex and index blobs inside the file */
+constexpr std::uint64_t MESH_PACK_ALIGNMENT = 64;
+
+/* file header, followed by numMeshes entries and the two blobs */
+struct MeshPackHeader
+{
+    char magic[4];              // "A3MP"
+    std::uint32_t version;
+    std::uint32_t numMeshes;
+    std::uint32_t vertexStride; // sizeof(Vertex) of the baker, has to match the runtime
+    std::uint64_t vertexOffset; // all vertices of all meshes, in entry order
+    std::uint64_t vertexBytes;
+    std::uint64_t indexOffset;  // all indices, relative to the first vertex of their mesh
+    std::uint64_t indexBytes;
+};
+
+/* one mesh of the pack, bounds are precomputed so loading doesn't touch the vertices */
+struct MeshPackEntry
+{
+    char name[32];
+    std::uint32_t firstVertex;
+    std::uint32_t numVertices;
+    std::uint32_t firstIndex;
+    std::uint32_t numIndices;
+    float boundsMin[3];
+    float boundsMax[3];
+    float boundsCenter[3];
+    float boundsRadius;
+};
+
+/* read-only memory mapping of a pack file */
+struct MeshPack
+{
+    const std::uint8_t* data = nullptr;
+    std::size_t size = 0;
+    const MeshPackHeader* header = nullptr;
+    const MeshPackEntry* entries = nullptr;
+
+    void* mapping = nullptr;    // platform handle of the mapping (Windows only)
+};
+
+/* mesh handed to the baker */
+struct MeshPackSource
+{
+    std::string name;
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+};
+
+/**
+ * @brief Maps a pack file into memory and validates the header, the entries and the indices, nothing is copied.
+ *
+ * @param path Pack file.
+ * @param pack Gets the mapping.
+ *
+ * @return False if the file couldn't be mapped or isn't a valid pack of this version.
+ */
+bool meshPackOpen(const std::string& path, MeshPack& pack);
+
+/**
+ * @brief Index of the mesh with the given name.
+ *
+ * @param pack Opened pack.
+ * @param name Mesh name.
+ *
+ * @return Entry index or -1 if there is no such mesh.
+ */
+int meshPackFind(const MeshPack& pack, const std::string& name);
+
+/**
+ * @brief Vertex and index data of all meshes, pointers into the mapping.
+ */
+const Vertex* meshPackVertices(const MeshPack& pack);
+const unsigned int* meshPackIndices(const MeshPack& pack);
+
+/**
+ * @brief Unmaps the file, meshes uploaded from it stay valid.
+ *
+ * @param pack Pack to close.
+ */
+void meshPackClose(MeshPack& pack);
+
+/**
+ * @brief Writes meshes into a pack file (used by the mesh baker).
+ *
+ * @param path Output file.
+ * @param meshes Meshes to write, names longer than 31 characters are cut.
+ *
+ * @return False if the file couldn't be written.
+ */
+bool meshPackWrite(const std::string& path, const std::vector<MeshPackSource>& meshes);
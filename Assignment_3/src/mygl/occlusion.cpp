@@ -0,0 +1,108 @@
+#include "occlusion.h"
+
+namespace detail
+{
+    /* exponential moving average, so single frames don't dominate the reported times */
+    void smooth(double &value, double sample)
+    {
+        value = value == 0.0 ? sample : 0.95 * value + 0.05 * sample;
+    }
+}
+
+OcclusionQueries occlusionCreate()
+{
+    OcclusionQueries occ;
+    glGenQueries(2, occ.timers);
+    return occ;
+}
+
+void occlusionBeginFrame(OcclusionQueries &occ, unsigned int numObjects, bool enabled)
+{
+    unsigned int current = occ.frame % 2;
+    unsigned int previous = 1 - current;
+
+    /* results of the previous frame, only the ones that are already available (never wait for the GPU) */
+    occ.stats.tested = 0;
+    occ.stats.occluded = 0;
+    for (std::size_t i = 0; i < occ.issued[previous].size(); i++) {
+        if (!occ.issued[previous][i]) {
+            continue;
+        }
+
+        GLuint available = GL_FALSE;
+        glGetQueryObjectuiv(occ.queries[previous][i], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available) {
+            GLuint anySamples = GL_TRUE;
+            glGetQueryObjectuiv(occ.queries[previous][i], GL_QUERY_RESULT, &anySamples);
+            occ.stats.tested++;
+            occ.stats.occluded += anySamples ? 0 : 1;
+        }
+    }
+
+    if (occ.timerIssued[previous]) {
+        GLuint available = GL_FALSE;
+        glGetQueryObjectuiv(occ.timers[previous], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available) {
+            GLuint64 elapsed = 0;
+            glGetQueryObjectui64v(occ.timers[previous], GL_QUERY_RESULT, &elapsed);
+            detail::smooth(occ.timerWithQueries[previous] ? occ.stats.gpuTimeOn : occ.stats.gpuTimeOff, elapsed * 1e-6);
+        }
+    }
+
+    /* one query per object and buffer, created when more objects show up */
+    for (unsigned int b = 0; b < 2; b++) {
+        std::size_t existing = occ.queries[b].size();
+        if (existing < numObjects) {
+            occ.queries[b].resize(numObjects);
+            glGenQueries(numObjects - existing, occ.queries[b].data() + existing);
+        }
+    }
+    occ.issued[current].assign(numObjects, 0);
+
+    glBeginQuery(GL_TIME_ELAPSED, occ.timers[current]);
+    occ.timerIssued[current] = true;
+    occ.timerWithQueries[current] = enabled;
+}
+
+void occlusionTest(OcclusionQueries &occ, unsigned int object, const Mesh &box, const Matrix4D &boxModel, GLint modelLocation)
+{
+    unsigned int current = occ.frame % 2;
+
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    glDepthMask(GL_FALSE);
+
+    glBeginQuery(GL_ANY_SAMPLES_PASSED, occ.queries[current][object]);
+    glUniformMatrix4fv(modelLocation, 1, GL_FALSE, boxModel.ptr());
+    meshDraw(box);
+    glEndQuery(GL_ANY_SAMPLES_PASSED);
+    occ.issued[current][object] = 1;
+
+    glDepthMask(GL_TRUE);
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+}
+
+void occlusionBeginConditional(const OcclusionQueries &occ, unsigned int object)
+{
+    /* the wait happens on the GPU only, the CPU keeps submitting */
+    glBeginConditionalRender(occ.queries[occ.frame % 2][object], GL_QUERY_WAIT);
+}
+
+void occlusionEndConditional()
+{
+    glEndConditionalRender();
+}
+
+void occlusionEndFrame(OcclusionQueries &occ)
+{
+    glEndQuery(GL_TIME_ELAPSED);
+    occ.frame++;
+}
+
+void occlusionDelete(OcclusionQueries &occ)
+{
+    for (auto &queries : occ.queries) {
+        glDeleteQueries(queries.size(), queries.data());
+        queries.clear();
+    }
+    glDeleteQueries(2, occ.timers);
+}
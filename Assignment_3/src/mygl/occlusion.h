@@ -0,0 +1,83 @@
+#pragma once
+
+#include "mesh.h"
+
+#include <vector>
+
+struct OcclusionStats
+{
+    unsigned int tested = 0;        // objects whose query result of the previous frame was available
+    unsigned int occluded = 0;      // ... and had no visible sample
+    double gpuTimeOn = 0.0;         // smoothed GPU time of the draw pass with occlusion queries (ms)
+    double gpuTimeOff = 0.0;        // smoothed GPU time of the draw pass without occlusion queries (ms)
+};
+
+/* GL_ANY_SAMPLES_PASSED queries per object, double buffered so results are read one frame late without stalling */
+struct OcclusionQueries
+{
+    std::vector<GLuint> queries[2];
+    std::vector<unsigned char> issued[2];
+    GLuint timers[2] = {0, 0};
+    bool timerIssued[2] = {false, false};
+    bool timerWithQueries[2] = {false, false};
+    unsigned int frame = 0;
+
+    OcclusionStats stats;
+};
+
+/**
+ * @brief Creates the timer queries, occlusion queries are created on demand in occlusionBeginFrame(...).
+ *
+ * @return Occlusion query state.
+ */
+OcclusionQueries occlusionCreate();
+
+/**
+ * @brief Starts a new frame: collects the (already available) results of the previous frame into the statistics,
+ * makes sure there is a query per object and starts the GPU timer of the draw pass.
+ *
+ * @param occ Occlusion query state.
+ * @param numObjects Number of objects that may be tested this frame.
+ * @param enabled Whether occlusion queries are used this frame (the timer runs in both cases for comparison).
+ */
+void occlusionBeginFrame(OcclusionQueries& occ, unsigned int numObjects, bool enabled);
+
+/**
+ * @brief Draws the bounding box of an object with color and depth writes disabled inside an occlusion query. The
+ * shader has to be in use and the vertex array object of the box mesh has to be bound.
+ *
+ * @param occ Occlusion query state.
+ * @param object Index of the object.
+ * @param box Unit cube mesh (vertices in [-1, 1]^3).
+ * @param boxModel Model matrix that maps the unit cube to the object's bounding box in world space.
+ * @param modelLocation Location of the model matrix uniform of the shader in use.
+ */
+void occlusionTest(OcclusionQueries& occ, unsigned int object, const Mesh& box, const Matrix4D& boxModel, GLint modelLocation);
+
+/**
+ * @brief Starts conditional rendering on the query of the object issued this frame, subsequent draw calls are skipped
+ * by the GPU if the bounding box was fully occluded.
+ *
+ * @param occ Occlusion query state.
+ * @param object Index of the object.
+ */
+void occlusionBeginConditional(const OcclusionQueries& occ, unsigned int object);
+
+/**
+ * @brief Ends conditional rendering started with occlusionBeginConditional(...).
+ */
+void occlusionEndConditional();
+
+/**
+ * @brief Stops the GPU timer of the draw pass and advances to the next query buffer.
+ *
+ * @param occ Occlusion query state.
+ */
+void occlusionEndFrame(OcclusionQueries& occ);
+
+/**
+ * @brief Deletes all query objects.
+ *
+ * @param occ Occlusion query state.
+ */
+void occlusionDelete(OcclusionQueries& occ);
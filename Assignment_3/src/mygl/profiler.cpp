@@ -0,0 +1,274 @@
+#include "profiler.h"
+
+#ifdef ENABLE_PROFILER
+
+#include <atomic>
+#include <cstdio>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+namespace detail
+{
+    /* GPU queries stay in flight for this many frames before their results are read */
+    constexpr unsigned int profilerFrames = 3;
+    /* upper bound of recorded events, so long runs don't grow without limit */
+    constexpr std::size_t profilerMaxEvents = 1u << 21;
+
+    constexpr int gpuTrack = 0;
+
+    struct ProfileEvent
+    {
+        const char *name;
+        int track;
+        double start;       // microseconds since profilerStart()
+        double duration;    // microseconds
+    };
+
+    struct GpuRange
+    {
+        const char *name;
+        GLuint begin;
+        GLuint end;
+    };
+
+    struct GpuFrame
+    {
+        std::vector<GLuint> queries;    // pool, grows on demand and is reused every profilerFrames frames
+        std::vector<GpuRange> ranges;
+        unsigned int numUsed = 0;
+    };
+
+    struct ProfilerState
+    {
+        std::atomic<bool> active{false};
+        std::string path;
+        std::chrono::steady_clock::time_point origin;
+
+        std::mutex mutex;
+        std::vector<ProfileEvent> events;
+        std::vector<std::string> trackNames;
+        unsigned int droppedEvents = 0;
+
+        GLint64 gpuOrigin = 0;          // GPU timestamp (ns) taken at origin
+        GpuFrame gpuFrames[profilerFrames];
+        unsigned int frame = 0;
+        unsigned int droppedGpu = 0;
+    };
+
+    ProfilerState &state()
+    {
+        static ProfilerState profiler;
+        return profiler;
+    }
+
+    double microseconds(std::chrono::steady_clock::time_point time)
+    {
+        return std::chrono::duration<double, std::micro>(time - state().origin).count();
+    }
+
+    /* small per-thread track ids, the first thread to record is assumed to be the render thread */
+    int track()
+    {
+        thread_local int id = -1;
+        if(id < 0)
+        {
+            ProfilerState &profiler = state();
+            std::lock_guard<std::mutex> lock(profiler.mutex);
+            id = static_cast<int>(profiler.trackNames.size());
+            profiler.trackNames.push_back(id == 1 ? "Render thread" : "Worker " + std::to_string(id - 1));
+        }
+        return id;
+    }
+
+    void record(const char *name, int track, double start, double duration)
+    {
+        ProfilerState &profiler = state();
+        std::lock_guard<std::mutex> lock(profiler.mutex);
+        if(profiler.events.size() < profilerMaxEvents)
+        {
+            profiler.events.push_back({name, track, start, duration});
+        }
+        else
+        {
+            profiler.droppedEvents++;
+        }
+    }
+
+    /* reads the timers of a frame, with wait == false only if all of them are available */
+    void collectGpuFrame(GpuFrame &frame, bool wait)
+    {
+        ProfilerState &profiler = state();
+        if(frame.ranges.empty())
+        {
+            return;
+        }
+
+        /* timestamps complete in order, so the last end query tells whether the whole frame is done */
+        GLuint available = GL_TRUE;
+        if(!wait)
+        {
+            glGetQueryObjectuiv(frame.ranges.back().end, GL_QUERY_RESULT_AVAILABLE, &available);
+        }
+
+        if(available)
+        {
+            for (const auto &range : frame.ranges) {
+                GLuint64 begin = 0, end = 0;
+                glGetQueryObjectui64v(range.begin, GL_QUERY_RESULT, &begin);
+                glGetQueryObjectui64v(range.end, GL_QUERY_RESULT, &end);
+                double start = (static_cast<double>(begin) - static_cast<double>(profiler.gpuOrigin)) / 1000.0;
+                record(range.name, gpuTrack, start, (static_cast<double>(end) - static_cast<double>(begin)) / 1000.0);
+            }
+        }
+        else
+        {
+            profiler.droppedGpu += static_cast<unsigned int>(frame.ranges.size());
+        }
+
+        frame.ranges.clear();
+        frame.numUsed = 0;
+    }
+
+    void writeTrace()
+    {
+        ProfilerState &profiler = state();
+        std::FILE *file = std::fopen(profiler.path.c_str(), "w");
+        if(!file)
+        {
+            std::cerr << "[Profiler] Couldn't write " << profiler.path << std::endl;
+            return;
+        }
+
+        std::fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+        for (std::size_t i = 0; i < profiler.trackNames.size(); i++) {
+            std::fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%zu,\"args\":{\"name\":\"%s\"}},\n",
+                         i, profiler.trackNames[i].c_str());
+        }
+        for (std::size_t i = 0; i < profiler.events.size(); i++) {
+            const ProfileEvent &event = profiler.events[i];
+            std::fprintf(file, "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}%s\n",
+                         event.name, event.track == gpuTrack ? "gpu" : "cpu", event.track, event.start, event.duration,
+                         i + 1 < profiler.events.size() ? "," : "");
+        }
+        std::fprintf(file, "]}\n");
+        std::fclose(file);
+
+        std::cout << "[Profiler] Wrote " << profiler.events.size() << " events to " << profiler.path;
+        if(profiler.droppedEvents || profiler.droppedGpu)
+        {
+            std::cout << " (dropped " << profiler.droppedEvents << " events over the limit, " << profiler.droppedGpu
+                      << " GPU timers not ready in time)";
+        }
+        std::cout << std::endl;
+    }
+}
+
+ProfileCpuScope::ProfileCpuScope(const char *name)
+    : name(name)
+{
+    if(detail::state().active.load(std::memory_order_relaxed))
+    {
+        start = std::chrono::steady_clock::now();
+    }
+    else
+    {
+        this->name = nullptr;
+    }
+}
+
+ProfileCpuScope::~ProfileCpuScope()
+{
+    if(name)
+    {
+        auto end = std::chrono::steady_clock::now();
+        detail::record(name, detail::track(), detail::microseconds(start), std::chrono::duration<double, std::micro>(end - start).count());
+    }
+}
+
+ProfileGpuScope::ProfileGpuScope(const char *name)
+    : range(-1)
+{
+    detail::ProfilerState &profiler = detail::state();
+    if(!profiler.active.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    detail::GpuFrame &frame = profiler.gpuFrames[profiler.frame % detail::profilerFrames];
+    if(frame.numUsed + 2 > frame.queries.size())
+    {
+        std::size_t size = frame.queries.size();
+        frame.queries.resize(size + 16);
+        glGenQueries(16, frame.queries.data() + size);
+    }
+
+    /* timestamps instead of GL_TIME_ELAPSED, elapsed queries can't nest (and the occlusion pass already uses one) */
+    GLuint begin = frame.queries[frame.numUsed++];
+    GLuint end = frame.queries[frame.numUsed++];
+    glQueryCounter(begin, GL_TIMESTAMP);
+
+    range = static_cast<int>(frame.ranges.size());
+    frame.ranges.push_back({name, begin, end});
+}
+
+ProfileGpuScope::~ProfileGpuScope()
+{
+    if(range >= 0)
+    {
+        detail::ProfilerState &profiler = detail::state();
+        detail::GpuFrame &frame = profiler.gpuFrames[profiler.frame % detail::profilerFrames];
+        glQueryCounter(frame.ranges[range].end, GL_TIMESTAMP);
+    }
+}
+
+void profilerStart(const std::string &path)
+{
+    detail::ProfilerState &profiler = detail::state();
+    profiler.path = path;
+    profiler.events.clear();
+    profiler.events.reserve(1u << 16);
+    profiler.trackNames.assign(1, "GPU");
+
+    /* both clocks read at (nearly) the same time, so GPU events line up with the CPU events */
+    glGetInteger64v(GL_TIMESTAMP, &profiler.gpuOrigin);
+    profiler.origin = std::chrono::steady_clock::now();
+
+    detail::track();
+    profiler.active = true;
+}
+
+void profilerEndFrame()
+{
+    detail::ProfilerState &profiler = detail::state();
+    if(!profiler.active)
+    {
+        return;
+    }
+
+    profiler.frame++;
+    detail::collectGpuFrame(profiler.gpuFrames[profiler.frame % detail::profilerFrames], false);
+}
+
+void profilerStop()
+{
+    detail::ProfilerState &profiler = detail::state();
+    if(!profiler.active)
+    {
+        return;
+    }
+    profiler.active = false;
+
+    for (auto &frame : profiler.gpuFrames) {
+        detail::collectGpuFrame(frame, true);
+        if(!frame.queries.empty())
+        {
+            glDeleteQueries(static_cast<GLsizei>(frame.queries.size()), frame.queries.data());
+        }
+        frame.queries.clear();
+    }
+
+    detail::writeTrace();
+}
+
+#endif
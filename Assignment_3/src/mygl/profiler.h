@@ -0,0 +1,83 @@
+#pragma once
+
+#include "alloctrack.h"
+#include "base.h"
+
+/*
+ * Scoped CPU and GPU timers written to a Chrome trace JSON file (open in chrome://tracing or ui.perfetto.dev).
+ *
+ * The instrumentation only exists if ENABLE_PROFILER is defined (all configurations except Release, see
+ * CMakeLists.txt), otherwise all macros expand to nothing. Use the macros, not the functions:
+ *
+ *   PROFILER_START("trace.json");
+ *   {
+ *       PROFILE_CPU("sceneUpdate");     // wall time of the enclosing scope on the calling thread
+ *       PROFILE_GPU("ground");          // GPU time of the GL commands issued in the enclosing scope
+ *       ...
+ *   }
+ *   PROFILER_END_FRAME();
+ *   PROFILER_STOP();                    // writes the file
+ *
+ * Names have to be string literals. GPU scopes may only be used on the thread owning the GL context. CPU scopes also
+ * name the allocations made inside them if allocation tracking is built (see alloctrack.h), in every configuration.
+ */
+
+#ifdef ENABLE_PROFILER
+
+#include <chrono>
+#include <string>
+
+struct ProfileCpuScope
+{
+    const char *name;
+    std::chrono::steady_clock::time_point start;
+
+    explicit ProfileCpuScope(const char *name);
+    ~ProfileCpuScope();
+};
+
+struct ProfileGpuScope
+{
+    int range;  // index of the query pair in the current frame, -1 if the profiler isn't running
+
+    explicit ProfileGpuScope(const char *name);
+    ~ProfileGpuScope();
+};
+
+/**
+ * @brief Starts recording events, calibrates the GPU clock against the CPU clock.
+ *
+ * @param path Path of the trace file written by profilerStop().
+ */
+void profilerStart(const std::string& path);
+
+/**
+ * @brief Marks the end of a frame: collects the GPU timers of an earlier frame whose results are available (never
+ * waits for the GPU) and advances to the next set of queries.
+ */
+void profilerEndFrame();
+
+/**
+ * @brief Collects the remaining GPU timers, writes the trace file and deletes the queries.
+ */
+void profilerStop();
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_CPU(name) ProfileCpuScope PROFILE_CONCAT(profileCpuScope, __LINE__)(name); ALLOC_SCOPE(name)
+#define PROFILE_GPU(name) ProfileGpuScope PROFILE_CONCAT(profileGpuScope, __LINE__)(name)
+#define PROFILER_START(path) profilerStart(path)
+#define PROFILER_END_FRAME() profilerEndFrame()
+#define PROFILER_STOP() profilerStop()
+#define PROFILER_AVAILABLE 1
+
+#else
+
+#define PROFILE_CPU(name) ALLOC_SCOPE(name)
+#define PROFILE_GPU(name) ((void)0)
+#define PROFILER_START(path) ((void)0)
+#define PROFILER_END_FRAME() ((void)0)
+#define PROFILER_STOP() ((void)0)
+#define PROFILER_AVAILABLE 0
+
+#endif
@@ -0,0 +1,249 @@
+#include "rangeallocator.h"
+
+#include <algorithm>
+
+namespace detail
+{
+    unsigned int log2(std::uint32_t value)
+    {
+        unsigned int result = 0;
+        while (value >>= 1) {
+            result++;
+        }
+        return result;
+    }
+
+    unsigned int lowestBit(std::uint32_t value)
+    {
+        unsigned int result = 0;
+        while (!(value & 1u)) {
+            value >>= 1;
+            result++;
+        }
+        return result;
+    }
+
+    /* size class of a block: small sizes get one class each, larger ones 16 classes per power of two */
+    void mapping(std::uint32_t size, unsigned int &fl, unsigned int &sl)
+    {
+        if(size < RANGE_ALLOCATOR_SL_COUNT)
+        {
+            fl = 0;
+            sl = size;
+            return;
+        }
+        unsigned int t = log2(size);
+        fl = t - RANGE_ALLOCATOR_SL_BITS + 1;
+        sl = (size >> (t - RANGE_ALLOCATOR_SL_BITS)) & (RANGE_ALLOCATOR_SL_COUNT - 1);
+    }
+
+    /* class from which every block is large enough, i.e. the size rounded up to the next class boundary */
+    void mappingSearch(std::uint32_t size, unsigned int &fl, unsigned int &sl)
+    {
+        if(size >= RANGE_ALLOCATOR_SL_COUNT)
+        {
+            std::uint64_t rounded = size + ((1ull << (log2(size) - RANGE_ALLOCATOR_SL_BITS)) - 1);
+            size = static_cast<std::uint32_t>(std::min<std::uint64_t>(rounded, 0xffffffffu));
+        }
+        mapping(size, fl, sl);
+    }
+
+    void insertFree(RangeAllocator &allocator, int index)
+    {
+        RangeBlock &block = allocator.blocks[index];
+        unsigned int fl, sl;
+        mapping(block.size, fl, sl);
+
+        block.free = true;
+        block.prevFree = -1;
+        block.nextFree = allocator.freeLists[fl][sl];
+        if(block.nextFree >= 0)
+        {
+            allocator.blocks[block.nextFree].prevFree = index;
+        }
+        allocator.freeLists[fl][sl] = index;
+        allocator.firstLevelMap |= 1u << fl;
+        allocator.secondLevelMap[fl] |= 1u << sl;
+    }
+
+    void removeFree(RangeAllocator &allocator, int index)
+    {
+        RangeBlock &block = allocator.blocks[index];
+        unsigned int fl, sl;
+        mapping(block.size, fl, sl);
+
+        if(block.prevFree >= 0)
+        {
+            allocator.blocks[block.prevFree].nextFree = block.nextFree;
+        }
+        else
+        {
+            allocator.freeLists[fl][sl] = block.nextFree;
+        }
+        if(block.nextFree >= 0)
+        {
+            allocator.blocks[block.nextFree].prevFree = block.prevFree;
+        }
+
+        if(allocator.freeLists[fl][sl] < 0)
+        {
+            allocator.secondLevelMap[fl] &= ~(1u << sl);
+            if(!allocator.secondLevelMap[fl])
+            {
+                allocator.firstLevelMap &= ~(1u << fl);
+            }
+        }
+        block.free = false;
+        block.prevFree = block.nextFree = -1;
+    }
+
+    int newBlock(RangeAllocator &allocator)
+    {
+        if(!allocator.unusedBlocks.empty())
+        {
+            int index = allocator.unusedBlocks.back();
+            allocator.unusedBlocks.pop_back();
+            allocator.blocks[index] = RangeBlock();
+            return index;
+        }
+        allocator.blocks.emplace_back();
+        return static_cast<int>(allocator.blocks.size() - 1);
+    }
+
+    /* appends the physical successor `right` of `left` to it */
+    void absorb(RangeAllocator &allocator, int left, int right)
+    {
+        RangeBlock &a = allocator.blocks[left];
+        RangeBlock &b = allocator.blocks[right];
+        a.size += b.size;
+        a.nextPhysical = b.nextPhysical;
+        if(a.nextPhysical >= 0)
+        {
+            allocator.blocks[a.nextPhysical].prevPhysical = left;
+        }
+        allocator.unusedBlocks.push_back(right);
+    }
+}
+
+RangeAllocator rangeAllocatorCreate(std::uint32_t capacity)
+{
+    RangeAllocator allocator;
+    allocator.capacity = capacity;
+    for (auto &lists : allocator.freeLists) {
+        std::fill(std::begin(lists), std::end(lists), -1);
+    }
+
+    if(capacity > 0)
+    {
+        int index = detail::newBlock(allocator);
+        allocator.blocks[index].size = capacity;
+        detail::insertFree(allocator, index);
+    }
+    return allocator;
+}
+
+bool rangeAllocatorAlloc(RangeAllocator &allocator, std::uint32_t size, std::uint32_t &offset)
+{
+    if(size == 0)
+    {
+        return false;
+    }
+
+    unsigned int fl, sl;
+    detail::mappingSearch(size, fl, sl);
+    if(fl >= RANGE_ALLOCATOR_FL_COUNT)
+    {
+        return false;
+    }
+
+    /* smallest non-empty class at or above the searched one */
+    std::uint32_t slMap = allocator.secondLevelMap[fl] & (~0u << sl);
+    if(!slMap)
+    {
+        std::uint32_t flMap = fl + 1 < 32 ? allocator.firstLevelMap & (~0u << (fl + 1)) : 0;
+        if(!flMap)
+        {
+            return false;
+        }
+        fl = detail::lowestBit(flMap);
+        slMap = allocator.secondLevelMap[fl];
+    }
+    sl = detail::lowestBit(slMap);
+
+    int index = allocator.freeLists[fl][sl];
+    detail::removeFree(allocator, index);
+
+    /* split off the rest as a new free block */
+    if(allocator.blocks[index].size > size)
+    {
+        int rest = detail::newBlock(allocator);
+        RangeBlock &block = allocator.blocks[index];
+        RangeBlock &restBlock = allocator.blocks[rest];
+        restBlock.offset = block.offset + size;
+        restBlock.size = block.size - size;
+        restBlock.prevPhysical = index;
+        restBlock.nextPhysical = block.nextPhysical;
+        if(block.nextPhysical >= 0)
+        {
+            allocator.blocks[block.nextPhysical].prevPhysical = rest;
+        }
+        block.nextPhysical = rest;
+        block.size = size;
+        detail::insertFree(allocator, rest);
+    }
+
+    offset = allocator.blocks[index].offset;
+    allocator.used[offset] = index;
+    allocator.usedSize += size;
+    return true;
+}
+
+bool rangeAllocatorFree(RangeAllocator &allocator, std::uint32_t offset)
+{
+    auto it = allocator.used.find(offset);
+    if(it == allocator.used.end())
+    {
+        return false;
+    }
+    int index = it->second;
+    allocator.used.erase(it);
+    allocator.usedSize -= allocator.blocks[index].size;
+
+    int next = allocator.blocks[index].nextPhysical;
+    if(next >= 0 && allocator.blocks[next].free)
+    {
+        detail::removeFree(allocator, next);
+        detail::absorb(allocator, index, next);
+    }
+    int prev = allocator.blocks[index].prevPhysical;
+    if(prev >= 0 && allocator.blocks[prev].free)
+    {
+        detail::removeFree(allocator, prev);
+        detail::absorb(allocator, prev, index);
+        index = prev;
+    }
+
+    detail::insertFree(allocator, index);
+    return true;
+}
+
+RangeAllocatorStats rangeAllocatorStats(const RangeAllocator &allocator)
+{
+    RangeAllocatorStats stats;
+    stats.capacity = allocator.capacity;
+    stats.used = allocator.usedSize;
+    stats.allocations = static_cast<std::uint32_t>(allocator.used.size());
+
+    for (unsigned int fl = 0; fl < RANGE_ALLOCATOR_FL_COUNT; fl++) {
+        for (unsigned int sl = 0; sl < RANGE_ALLOCATOR_SL_COUNT; sl++) {
+            for (int i = allocator.freeLists[fl][sl]; i >= 0; i = allocator.blocks[i].nextFree) {
+                stats.freeBlocks++;
+                stats.largestFree = std::max(stats.largestFree, allocator.blocks[i].size);
+            }
+        }
+    }
+
+    std::uint32_t freeSize = allocator.capacity - allocator.usedSize;
+    stats.fragmentation = freeSize ? 1.0f - static_cast<float>(stats.largestFree) / freeSize : 0.0f;
+    return stats;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/* TLSF (two-level segregated fit) sub-allocator for ranges of a fixed-size GPU buffer. Free blocks are kept in
+ * lists by size class: the first level is the power of two of the size, the second level splits it into 16
+ * linear steps. Two bitmaps find a fitting class in constant time, freed blocks merge with free neighbours. Sizes
+ * and offsets are in elements (e.g. vertices), the allocator never touches the buffer itself. */
+constexpr unsigned int RANGE_ALLOCATOR_SL_BITS = 4;
+constexpr unsigned int RANGE_ALLOCATOR_SL_COUNT = 1u << RANGE_ALLOCATOR_SL_BITS;
+constexpr unsigned int RANGE_ALLOCATOR_FL_COUNT = 30;
+
+struct RangeBlock
+{
+    std::uint32_t offset = 0;
+    std::uint32_t size = 0;
+    bool free = false;
+    int prevPhysical = -1;  // neighbours in the buffer
+    int nextPhysical = -1;
+    int prevFree = -1;      // neighbours in the free list of the size class
+    int nextFree = -1;
+};
+
+struct RangeAllocator
+{
+    std::uint32_t capacity = 0;
+    std::vector<RangeBlock> blocks;
+    std::vector<int> unusedBlocks;                  // recycled entries of blocks
+    std::unordered_map<std::uint32_t, int> used;    // offset of an allocation -> block
+
+    std::uint32_t firstLevelMap = 0;
+    std::uint32_t secondLevelMap[RANGE_ALLOCATOR_FL_COUNT] = {};
+    int freeLists[RANGE_ALLOCATOR_FL_COUNT][RANGE_ALLOCATOR_SL_COUNT];
+
+    std::uint32_t usedSize = 0;
+};
+
+struct RangeAllocatorStats
+{
+    std::uint32_t capacity = 0;
+    std::uint32_t used = 0;
+    std::uint32_t allocations = 0;
+    std::uint32_t freeBlocks = 0;
+    std::uint32_t largestFree = 0;
+    float fragmentation = 0.0f; // 1 - largest free block / free space, 0 if all free space is one block
+};
+
+/**
+ * @brief Creates an allocator with the whole range free.
+ *
+ * @param capacity Number of elements of the buffer.
+ *
+ * @return Range allocator.
+ */
+RangeAllocator rangeAllocatorCreate(std::uint32_t capacity);
+
+/**
+ * @brief Allocates a range.
+ *
+ * @param allocator Range allocator.
+ * @param size Number of elements (> 0).
+ * @param offset Gets the first element of the range.
+ *
+ * @return False if there is no free block large enough.
+ */
+bool rangeAllocatorAlloc(RangeAllocator& allocator, std::uint32_t size, std::uint32_t& offset);
+
+/**
+ * @brief Frees the range allocated at the given offset and merges it with free neighbours.
+ *
+ * @param allocator Range allocator.
+ * @param offset Offset returned by rangeAllocatorAlloc(...).
+ *
+ * @return False if there is no allocation at this offset.
+ */
+bool rangeAllocatorFree(RangeAllocator& allocator, std::uint32_t offset);
+
+/**
+ * @brief Usage and fragmentation of the allocator (walks the free lists).
+ *
+ * @param allocator Range allocator.
+ *
+ * @return Statistics.
+ */
+RangeAllocatorStats rangeAllocatorStats(const RangeAllocator& allocator);
@@ -0,0 +1,69 @@
+#include "scenegraph.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+int sceneGraphAddNode(SceneGraph &graph, int parent, const Matrix4D &local)
+{
+    int node = static_cast<int>(graph.parent.size());
+    assert(parent < node);
+
+    graph.parent.push_back(parent);
+    graph.local.push_back(local);
+    graph.world.push_back(local);
+    graph.dirty.push_back(1);
+    if (parent < 0) {
+        graph.roots.push_back(node);
+    }
+
+    return node;
+}
+
+void sceneGraphSetLocal(SceneGraph &graph, int node, const Matrix4D &local)
+{
+    if(std::memcmp(graph.local[node].n, local.n, sizeof(local.n)) == 0)
+    {
+        return;
+    }
+
+    graph.local[node] = local;
+    graph.dirty[node] = 1;
+}
+
+namespace detail
+{
+    unsigned int updateNodes(SceneGraph &graph, std::size_t begin, std::size_t end)
+    {
+        unsigned int updated = 0;
+
+        /* parents come first, so their dirty flag is final when the children are visited */
+        for (std::size_t i = begin; i < end; i++) {
+            int p = graph.parent[i];
+            if (p >= 0 && graph.dirty[p]) {
+                graph.dirty[i] = 1;
+            }
+
+            if (graph.dirty[i]) {
+                graph.world[i] = p >= 0 ? graph.world[p] * graph.local[i] : graph.local[i];
+                updated++;
+            }
+        }
+
+        /* clear the flags afterwards, children read the flag of their parent during the pass */
+        std::fill(graph.dirty.begin() + begin, graph.dirty.begin() + end, 0);
+        return updated;
+    }
+}
+
+unsigned int sceneGraphUpdateRoots(SceneGraph &graph, unsigned int rootBegin, unsigned int rootEnd)
+{
+    if (rootBegin >= rootEnd) {
+        return 0;
+    }
+
+    /* the subtree of a root ends where the next root starts */
+    std::size_t begin = graph.roots[rootBegin];
+    std::size_t end = rootEnd < graph.roots.size() ? graph.roots[rootEnd] : graph.parent.size();
+    return detail::updateNodes(graph, begin, end);
+}
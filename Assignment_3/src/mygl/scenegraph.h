@@ -0,0 +1,48 @@
+#pragma once
+
+#include "base.h"
+
+#include <vector>
+
+/* flat transform hierarchy, nodes are stored parent-before-child so one linear pass updates all world matrices */
+struct SceneGraph
+{
+    std::vector<int> parent;            // -1 for root nodes, otherwise always smaller than the node index
+    std::vector<Matrix4D> local;
+    std::vector<Matrix4D> world;        // contiguous, can be uploaded as is
+    std::vector<unsigned char> dirty;   // local transform changed since the last update
+    std::vector<int> roots;             // indices of all root nodes in ascending order
+};
+
+/**
+ * @brief Appends a transform node to the scene graph.
+ *
+ * @param graph Scene graph the node is added to.
+ * @param parent Index of the parent node or -1 for a root node (the parent has to exist already).
+ * @param local Transformation relative to the parent.
+ *
+ * @return Index of the new node.
+ */
+int sceneGraphAddNode(SceneGraph& graph, int parent, const Matrix4D& local);
+
+/**
+ * @brief Sets the local transform of a node. The node is only marked dirty if the matrix actually changed, so unchanged
+ * subtrees are skipped by the next sceneGraphUpdateRoots(...).
+ *
+ * @param graph Scene graph containing the node.
+ * @param node Index of the node.
+ * @param local New transformation relative to the parent.
+ */
+void sceneGraphSetLocal(SceneGraph& graph, int node, const Matrix4D& local);
+
+/**
+ * @brief Recomputes the world matrices of the dirty nodes and their descendants in the subtrees of the roots
+ * [rootBegin, rootEnd) (indices into graph.roots), [0, graph.roots.size()) updates the whole graph. Disjoint root ranges touch disjoint nodes, so they can be updated on different threads.
+ *
+ * @param graph Scene graph to update.
+ * @param rootBegin First root (index into graph.roots).
+ * @param rootEnd One past the last root (index into graph.roots).
+ *
+ * @return Number of recomputed world matrices.
+ */
+unsigned int sceneGraphUpdateRoots(SceneGraph& graph, unsigned int rootBegin, unsigned int rootEnd);
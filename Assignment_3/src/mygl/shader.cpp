@@ -7,12 +7,15 @@
 
 namespace detail
 {
-    void compile(GLuint handle, const char* source, const int size)
+    void submitCompile(GLuint handle, const char* source, const int size)
     {
-        GLint compileResult = 0;
-
         glShaderSource(handle, 1, &source, &size);
         glCompileShader(handle);
+    }
+
+    void checkCompile(GLuint handle)
+    {
+        GLint compileResult = 0;
         glGetShaderiv(handle, GL_COMPILE_STATUS, &compileResult);
 
         if(compileResult == GL_FALSE)
@@ -31,10 +34,14 @@ namespace detail
         }
     }
 
-    void link(GLuint handle)
+    void compile(GLuint handle, const char* source, const int size)
     {
-        glLinkProgram(handle);
+        submitCompile(handle, source, size);
+        checkCompile(handle);
+    }
 
+    void checkLink(GLuint handle)
+    {
         GLint result;
         glGetProgramiv(handle, GL_LINK_STATUS, &result);
 
@@ -57,64 +64,154 @@ namespace detail
             throw std::runtime_error((std::string("[Shader] ERROR link shaderprogram: \n") + programLog));
         }
     }
-}
 
-ShaderProgram shaderCreate(const std::string &vertexSource, const std::string &fragmentSource)
-{
-    ShaderProgram program{glCreateProgram(), glCreateShader(GL_VERTEX_SHADER), glCreateShader(GL_FRAGMENT_SHADER)};
+    void link(GLuint handle)
+    {
+        glLinkProgram(handle);
+        checkLink(handle);
+    }
 
-    if(!program._vertexID || !program._fragmentID || !program.id)
+    ShaderProgram createShaders()
     {
-        std::cerr << "[Shader] Couldn't create shader program!" << std::endl;
-        std::cerr.flush();
-        throw std::runtime_error("[Shader] Couldn't create shader program!");
+        ShaderProgram program{glCreateProgram(), glCreateShader(GL_VERTEX_SHADER), glCreateShader(GL_FRAGMENT_SHADER)};
+
+        if(!program._vertexID || !program._fragmentID || !program.id)
+        {
+            std::cerr << "[Shader] Couldn't create shader program!" << std::endl;
+            std::cerr.flush();
+            throw std::runtime_error("[Shader] Couldn't create shader program!");
+        }
+        return program;
     }
 
+    void setRetrievableHint(GLuint program, bool retrievableBinary)
+    {
+        if(retrievableBinary && GLAD_GL_ARB_get_program_binary)
+        {
+            glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        }
+    }
+}
+
+ShaderProgram shaderCreate(const std::string &vertexSource, const std::string &fragmentSource, bool retrievableBinary)
+{
+    ShaderProgram program = detail::createShaders();
+
     detail::compile(program._vertexID, vertexSource.c_str(), vertexSource.size());
     glAttachShader(program.id, program._vertexID);
 
     detail::compile(program._fragmentID, fragmentSource.c_str(), fragmentSource.size());
     glAttachShader(program.id, program._fragmentID);
 
+    detail::setRetrievableHint(program.id, retrievableBinary);
     detail::link(program.id);
+    program.modelLocation = glGetUniformLocation(program.id, "uModel");
 
     return program;
 }
 
-ShaderProgram shaderLoad(const std::string &vertexPath, const std::string &fragmentPath)
+ShaderProgram shaderCreateAsync(const std::string &vertexSource, const std::string &fragmentSource, bool retrievableBinary)
+{
+    /* let the driver pick the number of compiler threads, only has to be set once per context */
+    static bool compilerThreadsSet = false;
+    if(!compilerThreadsSet)
+    {
+        if(GLAD_GL_KHR_parallel_shader_compile)
+        {
+            glMaxShaderCompilerThreadsKHR(0xFFFFFFFFu);
+        }
+        else if(GLAD_GL_ARB_parallel_shader_compile)
+        {
+            glMaxShaderCompilerThreadsARB(0xFFFFFFFFu);
+        }
+        compilerThreadsSet = true;
+    }
+
+    ShaderProgram program = detail::createShaders();
+
+    /* no status query in between, each query would wait for the driver to finish that stage */
+    detail::submitCompile(program._vertexID, vertexSource.c_str(), vertexSource.size());
+    detail::submitCompile(program._fragmentID, fragmentSource.c_str(), fragmentSource.size());
+    glAttachShader(program.id, program._vertexID);
+    glAttachShader(program.id, program._fragmentID);
+
+    detail::setRetrievableHint(program.id, retrievableBinary);
+    glLinkProgram(program.id);
+
+    program._pending = true;
+    return program;
+}
+
+bool shaderIsReady(const ShaderProgram &program)
+{
+    if(!program._pending || !(GLAD_GL_KHR_parallel_shader_compile || GLAD_GL_ARB_parallel_shader_compile))
+    {
+        return true;
+    }
+
+    GLint completed = GL_FALSE;
+    glGetProgramiv(program.id, GL_COMPLETION_STATUS_KHR, &completed);
+    return completed == GL_TRUE;
+}
+
+void shaderFinish(ShaderProgram &program)
 {
-    std::ifstream vertexFile(vertexPath);
-    std::ifstream fragmentFile(fragmentPath);
+    if(!program._pending)
+    {
+        return;
+    }
 
-    if(!vertexFile.is_open())
+    /* a failed link is usually caused by a failed compile, whose log is more helpful */
+    GLint linked = GL_FALSE;
+    glGetProgramiv(program.id, GL_LINK_STATUS, &linked);
+    if(linked == GL_FALSE)
     {
-        std::cerr << "[Shader] Couldn't open vertex shader file at " << std::endl;
-        std::cerr.flush();
-        throw std::runtime_error("[Shader] Couldn't open vertex shader file at " + vertexPath);
+        detail::checkCompile(program._vertexID);
+        detail::checkCompile(program._fragmentID);
+        detail::checkLink(program.id);
     }
 
-    if(!fragmentFile.is_open())
+    program.modelLocation = glGetUniformLocation(program.id, "uModel");
+    program._pending = false;
+}
+
+std::string shaderReadFile(const std::string &path)
+{
+    std::ifstream file(path);
+
+    if(!file.is_open())
     {
-        std::cerr << "[Shader] Couldn't open fragment shader file at " << std::endl;
+        std::cerr << "[Shader] Couldn't open shader file at " << path << std::endl;
         std::cerr.flush();
-        throw std::runtime_error("[Shader] Couldn't open fragment shader file at " + fragmentPath);
+        throw std::runtime_error("[Shader] Couldn't open shader file at " + path);
     }
 
-    std::stringstream vertexSourceBuffer;
-    vertexSourceBuffer << vertexFile.rdbuf();
+    std::stringstream sourceBuffer;
+    sourceBuffer << file.rdbuf();
+    return sourceBuffer.str();
+}
 
-    std::stringstream fragmentSourceBuffer;
-    fragmentSourceBuffer << fragmentFile.rdbuf();
+ShaderProgram shaderLoad(const std::string &vertexPath, const std::string &fragmentPath)
+{
+    std::string vertexSource = shaderReadFile(vertexPath);
+    std::string fragmentSource = shaderReadFile(fragmentPath);
 
-    return shaderCreate(vertexSourceBuffer.str(), fragmentSourceBuffer.str());
+    return shaderCreate(vertexSource, fragmentSource);
 }
 
 void shaderDelete(const ShaderProgram &program)
 {
-    glDetachShader(program.id, program._vertexID);
-    glDetachShader(program.id, program._fragmentID);
-    glDeleteShader(program._vertexID);
-    glDeleteShader(program._fragmentID);
+    /* programs restored from a binary have no shader objects */
+    if(program._vertexID)
+    {
+        glDetachShader(program.id, program._vertexID);
+        glDeleteShader(program._vertexID);
+    }
+    if(program._fragmentID)
+    {
+        glDetachShader(program.id, program._fragmentID);
+        glDeleteShader(program._fragmentID);
+    }
 
     glDeleteProgram(program.id);
 }
@@ -7,6 +7,8 @@ struct ShaderProgram
     GLuint id = 0;
     GLuint _vertexID = 0;
     GLuint _fragmentID = 0;
+    bool _pending = false;      // submitted with shaderCreateAsync(...), compile and link status not checked yet
+    GLint modelLocation = -1;   // location of uModel, resolved once the program is linked (-1 if the shader has none)
 };
 
 /**
@@ -19,15 +21,58 @@ struct ShaderProgram
  */
 ShaderProgram shaderLoad(const std::string& vertexPath, const std::string& fragmentPath);
 
+/**
+ * @brief Function to read a shader source file.
+ *
+ * @param path Path to shader file.
+ *
+ * @return Content of the file.
+ */
+std::string shaderReadFile(const std::string& path);
+
 /**
  * @brief Function to compile and link vertex and fragement source strings to create shader program.
  *
  * @param vertexSource Source string holding vertex shader code.
  * @param fragmentSource Source string holding fragment shader code.
+ * @param retrievableBinary Hint the driver that the program binary will be read back (see shaderCreateCached(...)).
  *
  * @return Shader program.
  */
-ShaderProgram shaderCreate(const std::string& vertexSource, const std::string& fragmentSource);
+ShaderProgram shaderCreate(const std::string& vertexSource, const std::string& fragmentSource, bool retrievableBinary = false);
+
+/**
+ * @brief Same as shaderCreate(...), but only submits compiling and linking to the driver without waiting for the
+ * result. With GL_KHR_parallel_shader_compile the driver compiles on its own threads, so many programs can be submitted
+ * at once and are built in parallel. The program has to be passed to shaderFinish(...) before it is used.
+ *
+ * @param vertexSource Source string holding vertex shader code.
+ * @param fragmentSource Source string holding fragment shader code.
+ * @param retrievableBinary Hint the driver that the program binary will be read back (see shaderCreateCached(...)).
+ *
+ * @return Shader program whose status is not checked yet.
+ */
+ShaderProgram shaderCreateAsync(const std::string& vertexSource, const std::string& fragmentSource, bool retrievableBinary = false);
+
+/**
+ * @brief Checks without blocking whether the driver has finished building a program submitted with
+ * shaderCreateAsync(...). Always true without GL_KHR_parallel_shader_compile (or the ARB version).
+ *
+ * @param program Shader program.
+ *
+ * @return True if shaderFinish(...) won't block.
+ */
+bool shaderIsReady(const ShaderProgram& program);
+
+/**
+ * @brief Waits until a program submitted with shaderCreateAsync(...) is built and checks the compile and link status.
+ * Does nothing for programs that are already checked.
+ *
+ * @param program Shader program.
+ *
+ * @throws std::runtime_error if compiling or linking failed.
+ */
+void shaderFinish(ShaderProgram& program);
 
 /**
  * @brief Cleanup and delete all shaders of a shader program and the program itself. Has to be called for each shader program after it is not used anymore.
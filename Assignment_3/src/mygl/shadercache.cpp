@@ -0,0 +1,181 @@
+#include "shadercache.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace detail
+{
+    void fnv1a(std::uint64_t &hash, const void *data, std::size_t size)
+    {
+        const unsigned char *bytes = static_cast<const unsigned char *>(data);
+        for (std::size_t i = 0; i < size; i++) {
+            hash ^= bytes[i];
+            hash *= 0x100000001b3ull;
+        }
+    }
+
+    void fnv1a(std::uint64_t &hash, const std::string &text)
+    {
+        /* include the length, so ("ab", "c") and ("a", "bc") differ */
+        std::uint64_t size = text.size();
+        fnv1a(hash, &size, sizeof(size));
+        fnv1a(hash, text.data(), text.size());
+    }
+
+    std::string glString(GLenum name)
+    {
+        const GLubyte *value = glGetString(name);
+        return value ? reinterpret_cast<const char *>(value) : "";
+    }
+
+    /* file layout: binary format (GLenum) followed by the raw program binary */
+    bool readBinary(const std::string &path, GLenum &format, std::vector<char> &binary)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if(!file.is_open())
+        {
+            return false;
+        }
+
+        file.seekg(0, std::ios::end);
+        std::streamoff size = file.tellg();
+        file.seekg(0, std::ios::beg);
+        if(size <= static_cast<std::streamoff>(sizeof(GLenum)))
+        {
+            return false;
+        }
+
+        binary.resize(static_cast<std::size_t>(size) - sizeof(GLenum));
+        file.read(reinterpret_cast<char *>(&format), sizeof(GLenum));
+        file.read(binary.data(), binary.size());
+        return static_cast<bool>(file);
+    }
+
+    void writeBinary(const std::string &path, GLuint program)
+    {
+        GLint length = 0;
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+        if(length <= 0)
+        {
+            return;
+        }
+
+        std::vector<char> binary(length);
+        GLenum format = 0;
+        glGetProgramBinary(program, length, nullptr, &format, binary.data());
+
+        /* write to a temporary file first, so a crash never leaves a truncated cache entry behind */
+        std::string tmpPath = path + ".tmp";
+        {
+            std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+            if(!file.is_open())
+            {
+                std::cerr << "[Shader] Couldn't write program cache file " << tmpPath << std::endl;
+                return;
+            }
+            file.write(reinterpret_cast<const char *>(&format), sizeof(GLenum));
+            file.write(binary.data(), binary.size());
+        }
+
+        std::error_code error;
+        std::filesystem::rename(tmpPath, path, error);
+        if(error)
+        {
+            std::cerr << "[Shader] Couldn't write program cache file " << path << ": " << error.message() << std::endl;
+        }
+    }
+}
+
+std::string shaderCacheKey(const std::string &vertexSource, const std::string &fragmentSource)
+{
+    std::uint64_t hash = 0xcbf29ce484222325ull;
+    detail::fnv1a(hash, vertexSource);
+    detail::fnv1a(hash, fragmentSource);
+    detail::fnv1a(hash, detail::glString(GL_VENDOR));
+    detail::fnv1a(hash, detail::glString(GL_RENDERER));
+    detail::fnv1a(hash, detail::glString(GL_VERSION));
+
+    static const char digits[] = "0123456789abcdef";
+    std::string key(16, '0');
+    for (int i = 15; i >= 0; i--) {
+        key[i] = digits[hash & 0xf];
+        hash >>= 4;
+    }
+    return key;
+}
+
+bool shaderCacheSupported()
+{
+    GLint numFormats = 0;
+    if(GLAD_GL_ARB_get_program_binary)
+    {
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+    }
+    return numFormats > 0;
+}
+
+std::string shaderCachePath(const std::string &vertexSource, const std::string &fragmentSource, const std::string &cacheDir)
+{
+    return (std::filesystem::path(cacheDir) / (shaderCacheKey(vertexSource, fragmentSource) + ".bin")).string();
+}
+
+bool shaderCacheLoad(const std::string &path, ShaderProgram &program, ShaderCacheStats &stats)
+{
+    GLenum format = 0;
+    std::vector<char> binary;
+    if(!detail::readBinary(path, format, binary))
+    {
+        return false;
+    }
+
+    GLuint id = glCreateProgram();
+    glProgramBinary(id, format, binary.data(), static_cast<GLsizei>(binary.size()));
+
+    GLint linked = GL_FALSE;
+    glGetProgramiv(id, GL_LINK_STATUS, &linked);
+    if(linked != GL_TRUE)
+    {
+        /* the driver may reject binaries at any time (driver update, different GPU) */
+        glDeleteProgram(id);
+        stats.rejected++;
+        return false;
+    }
+
+    program = ShaderProgram{id};
+    program.modelLocation = glGetUniformLocation(id, "uModel");
+    stats.hits++;
+    return true;
+}
+
+void shaderCacheStore(const std::string &path, const ShaderProgram &program)
+{
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path(), error);
+    detail::writeBinary(path, program.id);
+}
+
+ShaderProgram shaderCreateCached(const std::string &vertexSource, const std::string &fragmentSource, const std::string &cacheDir, ShaderCacheStats &stats)
+{
+    if(!shaderCacheSupported())
+    {
+        stats.unsupported++;
+        return shaderCreate(vertexSource, fragmentSource);
+    }
+
+    std::string path = shaderCachePath(vertexSource, fragmentSource, cacheDir);
+
+    ShaderProgram program;
+    if(shaderCacheLoad(path, program, stats))
+    {
+        return program;
+    }
+
+    stats.misses++;
+    program = shaderCreate(vertexSource, fragmentSource, true);
+    shaderCacheStore(path, program);
+
+    return program;
+}
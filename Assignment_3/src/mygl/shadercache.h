@@ -0,0 +1,76 @@
+#pragma once
+
+#include "shader.h"
+
+#include <string>
+
+struct ShaderCacheStats
+{
+    unsigned int hits = 0;          // programs restored with glProgramBinary
+    unsigned int misses = 0;        // programs compiled from source (and written to the cache)
+    unsigned int rejected = 0;      // cache files the driver didn't accept (e.g. after a driver update)
+    unsigned int unsupported = 0;   // programs compiled without the cache, the driver has no binary formats
+};
+
+/**
+ * @brief Same as shaderCreate(...), but uses an on-disk cache of program binaries. The cache file is keyed by a hash of
+ * both sources and the GL vendor, renderer and version strings. If the binary is missing or rejected by the driver,
+ * the program is compiled from source and the cache file is (re)written. Without GL_ARB_get_program_binary support
+ * this is the same as shaderCreate(...).
+ *
+ * @param vertexSource Source string holding vertex shader code (with all defines injected).
+ * @param fragmentSource Source string holding fragment shader code (with all defines injected).
+ * @param cacheDir Directory holding the cache files, created if it doesn't exist.
+ * @param stats Statistics that get the hit/miss/rejected counters updated.
+ *
+ * @return Shader program.
+ */
+ShaderProgram shaderCreateCached(const std::string& vertexSource, const std::string& fragmentSource, const std::string& cacheDir, ShaderCacheStats& stats);
+
+/**
+ * @brief 64 bit FNV-1a hash of the two sources and the GL driver strings, used as the cache file name.
+ *
+ * @param vertexSource Source string holding vertex shader code.
+ * @param fragmentSource Source string holding fragment shader code.
+ *
+ * @return Hash as 16 hex digits.
+ */
+std::string shaderCacheKey(const std::string& vertexSource, const std::string& fragmentSource);
+
+/**
+ * @brief Checks whether program binaries can be cached (GL_ARB_get_program_binary with at least one binary format).
+ *
+ * @return True if the cache can be used.
+ */
+bool shaderCacheSupported();
+
+/**
+ * @brief Path of the cache file of a program.
+ *
+ * @param vertexSource Source string holding vertex shader code.
+ * @param fragmentSource Source string holding fragment shader code.
+ * @param cacheDir Directory holding the cache files.
+ *
+ * @return Path of the cache file, which may not exist yet.
+ */
+std::string shaderCachePath(const std::string& vertexSource, const std::string& fragmentSource, const std::string& cacheDir);
+
+/**
+ * @brief Creates a program from a cache file.
+ *
+ * @param path Path of the cache file.
+ * @param program Gets the restored program on success.
+ * @param stats Statistics, counts a hit or a rejected binary.
+ *
+ * @return False if the file doesn't exist or the driver rejected the binary.
+ */
+bool shaderCacheLoad(const std::string& path, ShaderProgram& program, ShaderCacheStats& stats);
+
+/**
+ * @brief Writes the binary of a linked program to a cache file. The program should be created with the retrievable
+ * binary hint.
+ *
+ * @param path Path of the cache file, missing directories are created.
+ * @param program Linked shader program.
+ */
+void shaderCacheStore(const std::string& path, const ShaderProgram& program);
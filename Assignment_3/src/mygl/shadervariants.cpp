@@ -0,0 +1,146 @@
+#include "shadervariants.h"
+
+#include "views.h"
+
+ShaderVariants shaderVariantsLoad(const std::string &vertexPath, const std::string &fragmentPath, const std::vector<std::string> &featureNames)
+{
+    ShaderVariants variants;
+    variants.vertexSource = shaderReadFile(vertexPath);
+    variants.fragmentSource = shaderReadFile(fragmentPath);
+    variants.featureNames = featureNames;
+    return variants;
+}
+
+namespace detail
+{
+    std::vector<std::string> featureDefines(const ShaderVariants &variants, unsigned int features)
+    {
+        std::vector<std::string> defines;
+        for (unsigned int i = 0; i < variants.featureNames.size(); i++) {
+            if (features & (1u << i)) {
+                defines.push_back(variants.featureNames[i]);
+            }
+        }
+        return defines;
+    }
+}
+
+void shaderVariantsPrepare(ShaderVariants &variants, const std::vector<unsigned int> &featureSets)
+{
+    bool useCache = !variants.cacheDir.empty() && shaderCacheSupported();
+
+    for (unsigned int features : featureSets) {
+        if(variants.programs.count(features))
+        {
+            continue;
+        }
+
+        std::vector<std::string> defines = detail::featureDefines(variants, features);
+        std::string vertexSource = shaderInjectDefines(variants.vertexSource, defines);
+        std::string fragmentSource = shaderInjectDefines(variants.fragmentSource, defines);
+
+        std::string cachePath;
+        if(useCache)
+        {
+            cachePath = shaderCachePath(vertexSource, fragmentSource, variants.cacheDir);
+
+            ShaderProgram program;
+            if(shaderCacheLoad(cachePath, program, variants.cacheStats))
+            {
+                viewSetBindShader(program);
+                variants.programs.emplace(features, program);
+                continue;
+            }
+        }
+        if(useCache)
+        {
+            variants.cacheStats.misses++;
+        }
+        else if(!variants.cacheDir.empty())
+        {
+            variants.cacheStats.unsupported++;
+        }
+
+        /* the binary is written once the program is finished in shaderVariant(...) */
+        variants.programs.emplace(features, shaderCreateAsync(vertexSource, fragmentSource, useCache));
+        if(useCache)
+        {
+            variants.pendingCachePaths.emplace(features, cachePath);
+        }
+    }
+}
+
+bool shaderVariantReady(const ShaderVariants &variants, unsigned int features)
+{
+    auto it = variants.programs.find(features);
+    return it != variants.programs.end() && shaderIsReady(it->second);
+}
+
+ShaderProgram &shaderVariant(ShaderVariants &variants, unsigned int features)
+{
+    auto it = variants.programs.find(features);
+    if(it != variants.programs.end())
+    {
+        if(it->second._pending)
+        {
+            shaderFinish(it->second);
+            viewSetBindShader(it->second);
+
+            auto cachePath = variants.pendingCachePaths.find(features);
+            if(cachePath != variants.pendingCachePaths.end())
+            {
+                shaderCacheStore(cachePath->second, it->second);
+                variants.pendingCachePaths.erase(cachePath);
+            }
+        }
+        return it->second;
+    }
+
+    std::vector<std::string> defines = detail::featureDefines(variants, features);
+    std::string vertexSource = shaderInjectDefines(variants.vertexSource, defines);
+    std::string fragmentSource = shaderInjectDefines(variants.fragmentSource, defines);
+    ShaderProgram program = variants.cacheDir.empty()
+        ? shaderCreate(vertexSource, fragmentSource)
+        : shaderCreateCached(vertexSource, fragmentSource, variants.cacheDir, variants.cacheStats);
+    viewSetBindShader(program);
+    return variants.programs.emplace(features, program).first->second;
+}
+
+std::string shaderInjectDefines(const std::string &source, const std::vector<std::string> &defines)
+{
+    if(defines.empty())
+    {
+        return source;
+    }
+
+    std::string block;
+    for (const auto &define : defines) {
+        block += "#define " + define + "\n";
+    }
+
+    /* #version has to stay the first statement, so the defines go right after its line */
+    std::size_t version = source.find("#version");
+    std::size_t insertAt = 0;
+    if(version != std::string::npos)
+    {
+        std::size_t lineEnd = source.find('\n', version);
+        insertAt = lineEnd == std::string::npos ? source.size() : lineEnd + 1;
+    }
+
+    std::string result = source;
+    if(insertAt == result.size() && !result.empty() && result.back() != '\n')
+    {
+        result += '\n';
+        insertAt++;
+    }
+    return result.insert(insertAt, block);
+}
+
+void shaderVariantsDelete(ShaderVariants &variants)
+{
+    for (const auto &entry : variants.programs) {
+        shaderDelete(entry.second);
+    }
+    variants.programs.clear();
+    variants.pendingCachePaths.clear();
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "shader.h"
+#include "shadercache.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/* one vertex/fragment source pair compiled into variants, a variant is selected by a bit mask of feature flags */
+struct ShaderVariants
+{
+    std::string vertexSource;
+    std::string fragmentSource;
+    std::vector<std::string> featureNames;  // bit i of the feature mask enables #define featureNames[i]
+
+    std::unordered_map<unsigned int, ShaderProgram> programs;
+
+    std::string cacheDir;                   // program binary cache directory, empty disables the cache
+    ShaderCacheStats cacheStats;
+    std::unordered_map<unsigned int, std::string> pendingCachePaths;   // cache files to write once a program is finished
+};
+
+/**
+ * @brief Load vertex and fragment shader source from file. No program is compiled yet, variants are compiled on first
+ * use by shaderVariant(...).
+ *
+ * @param vertexPath Path to vertex shader file.
+ * @param fragmentPath Path to fragment shader file.
+ * @param featureNames Define names of the feature flags (bit i of a feature mask belongs to featureNames[i]).
+ *
+ * @return Shader variants without compiled programs.
+ */
+ShaderVariants shaderVariantsLoad(const std::string& vertexPath, const std::string& fragmentPath, const std::vector<std::string>& featureNames);
+
+/**
+ * @brief Submits all given variants to the driver at once without waiting for any of them (see shaderCreateAsync(...)),
+ * so they are compiled in parallel. Variants found in the program binary cache are restored right away. The status of
+ * a submitted variant is checked when it is first requested with shaderVariant(...).
+ *
+ * @param variants Shader variants.
+ * @param featureSets Feature masks of the variants to build.
+ */
+void shaderVariantsPrepare(ShaderVariants& variants, const std::vector<unsigned int>& featureSets);
+
+/**
+ * @brief Checks without blocking whether a variant is built, e.g. to keep using another variant until it is.
+ *
+ * @param variants Shader variants.
+ * @param features Bit mask of enabled features.
+ *
+ * @return True if shaderVariant(...) returns the variant without waiting for the driver.
+ */
+bool shaderVariantReady(const ShaderVariants& variants, unsigned int features);
+
+/**
+ * @brief Get the program for a combination of feature flags. The program is compiled and linked the first time the
+ * combination is requested and cached afterwards. Variants submitted with shaderVariantsPrepare(...) are waited for and
+ * checked on their first request. If variants.cacheDir is set, the program binary is also cached on
+ * disk (see shaderCreateCached(...)). The `View` uniform block of each program is bound once it is linked or restored
+ * (see viewSetBindShader(...)).
+ *
+ * @param variants Shader variants.
+ * @param features Bit mask of enabled features.
+ *
+ * @return Shader program of the variant.
+ *
+ * usage:
+ *
+ *   ShaderVariants shaders = shaderVariantsLoad("shader/default.vert", "shader/default.frag", {"CHECKERBOARD"});
+ *   ShaderProgram &program = shaderVariant(shaders, checkerboard ? 1u : 0u);
+ *   glUseProgram(program.id);
+ *
+ */
+ShaderProgram& shaderVariant(ShaderVariants& variants, unsigned int features);
+
+/**
+ * @brief Inserts "#define NAME" lines for all given names directly after the #version line of a GLSL source.
+ *
+ * @param source GLSL source code.
+ * @param defines Names to define.
+ *
+ * @return Source with the defines injected.
+ */
+std::string shaderInjectDefines(const std::string& source, const std::vector<std::string>& defines);
+
+/**
+ * @brief Cleanup and delete all compiled variants.
+ *
+ * @param variants Shader variants to delete.
+ */
+void shaderVariantsDelete(ShaderVariants& variants);
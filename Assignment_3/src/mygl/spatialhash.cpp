@@ -0,0 +1,177 @@
+#include "spatialhash.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace detail
+{
+    int gridCell(float value, float cellSize)
+    {
+        return static_cast<int>(std::floor(value / cellSize));
+    }
+
+    unsigned int gridSlot(int x, int z, unsigned int mask)
+    {
+        return ((static_cast<unsigned int>(x) * 73856093u) ^ (static_cast<unsigned int>(z) * 19349663u)) & mask;
+    }
+
+    /* calls visit(object) once for every object in the cells [minX, maxX] x [minZ, maxZ], or for all objects if the
+     * range has more cells than there are objects */
+    template <typename Visit>
+    void visitCells(const SpatialHash &hash, float minX, float maxX, float minZ, float maxZ, const Visit &visit)
+    {
+        double cellsX = std::floor(maxX / hash.cellSize) - std::floor(minX / hash.cellSize) + 1.0;
+        double cellsZ = std::floor(maxZ / hash.cellSize) - std::floor(minZ / hash.cellSize) + 1.0;
+        if(cellsX * cellsZ > static_cast<double>(hash.positions.size()))
+        {
+            for (unsigned int i = 0; i < hash.positions.size(); i++) {
+                visit(i);
+            }
+            return;
+        }
+
+        int x0 = gridCell(minX, hash.cellSize), x1 = gridCell(maxX, hash.cellSize);
+        int z0 = gridCell(minZ, hash.cellSize), z1 = gridCell(maxZ, hash.cellSize);
+        for (int z = z0; z <= z1; z++) {
+            for (int x = x0; x <= x1; x++) {
+                unsigned int slot = gridSlot(x, z, hash.tableMask);
+                for (unsigned int k = hash.slotStart[slot]; k < hash.slotStart[slot + 1]; k++) {
+                    unsigned int object = hash.entries[k];
+                    /* other cells hashed to the same slot */
+                    if(hash.cellX[object] == x && hash.cellZ[object] == z)
+                    {
+                        visit(object);
+                    }
+                }
+            }
+        }
+    }
+
+    float distanceSquared(const Vector3D &a, const Vector3D &b)
+    {
+        Vector3D d = a - b;
+        return d.x * d.x + d.y * d.y + d.z * d.z;
+    }
+
+    void collectPairs(const SpatialHash &hash, float distance, unsigned int begin, unsigned int end, SpatialHashPairs &pairs)
+    {
+        float distanceSq = distance * distance;
+        for (unsigned int i = begin; i < end; i++) {
+            const Vector3D &p = hash.positions[i];
+            visitCells(hash, p.x - distance, p.x + distance, p.z - distance, p.z + distance, [&](unsigned int j) {
+                if(j > i && distanceSquared(p, hash.positions[j]) <= distanceSq)
+                {
+                    pairs.emplace_back(i, j);
+                }
+            });
+        }
+    }
+}
+
+SpatialHash spatialHashCreate(float cellSize)
+{
+    SpatialHash hash;
+    hash.cellSize = cellSize > 0.0f ? cellSize : 1.0f;
+    return hash;
+}
+
+void spatialHashBuild(SpatialHash &hash, const std::vector<Vector3D> &positions, ThreadPool *pool)
+{
+    unsigned int count = static_cast<unsigned int>(positions.size());
+    unsigned int tableSize = 16;
+    while (tableSize < 2 * count) {
+        tableSize *= 2;
+    }
+    hash.tableMask = tableSize - 1;
+
+    hash.positions = positions;
+    hash.cellX.resize(count);
+    hash.cellZ.resize(count);
+    hash.slots.resize(count);
+    auto computeSlots = [&hash](unsigned int begin, unsigned int end, unsigned int) {
+        for (unsigned int i = begin; i < end; i++) {
+            hash.cellX[i] = detail::gridCell(hash.positions[i].x, hash.cellSize);
+            hash.cellZ[i] = detail::gridCell(hash.positions[i].z, hash.cellSize);
+            hash.slots[i] = detail::gridSlot(hash.cellX[i], hash.cellZ[i], hash.tableMask);
+        }
+    };
+    if(pool)
+    {
+        threadPoolParallelFor(*pool, count, computeSlots);
+    }
+    else
+    {
+        computeSlots(0, count, 0);
+    }
+
+    /* counting sort: sizes -> start offsets, scattering advances each start to the end of its slot, which is the
+     * start of the next one */
+    hash.slotStart.assign(tableSize + 1, 0);
+    for (unsigned int i = 0; i < count; i++) {
+        hash.slotStart[hash.slots[i]]++;
+    }
+    unsigned int offset = 0;
+    for (unsigned int s = 0; s < tableSize; s++) {
+        unsigned int size = hash.slotStart[s];
+        hash.slotStart[s] = offset;
+        offset += size;
+    }
+    hash.entries.resize(count);
+    for (unsigned int i = 0; i < count; i++) {
+        hash.entries[hash.slotStart[hash.slots[i]]++] = i;
+    }
+    for (unsigned int s = tableSize; s > 0; s--) {
+        hash.slotStart[s] = hash.slotStart[s - 1];
+    }
+    hash.slotStart[0] = 0;
+}
+
+void spatialHashQueryRadius(const SpatialHash &hash, const Vector3D &center, float radius, std::vector<unsigned int> &result)
+{
+    result.clear();
+    float radiusSq = radius * radius;
+    detail::visitCells(hash, center.x - radius, center.x + radius, center.z - radius, center.z + radius, [&](unsigned int i) {
+        if(detail::distanceSquared(center, hash.positions[i]) <= radiusSq)
+        {
+            result.push_back(i);
+        }
+    });
+}
+
+void spatialHashQueryBox(const SpatialHash &hash, const Vector3D &boxMin, const Vector3D &boxMax, std::vector<unsigned int> &result)
+{
+    result.clear();
+    detail::visitCells(hash, boxMin.x, boxMax.x, boxMin.z, boxMax.z, [&](unsigned int i) {
+        const Vector3D &p = hash.positions[i];
+        if(p.x >= boxMin.x && p.x <= boxMax.x && p.y >= boxMin.y && p.y <= boxMax.y && p.z >= boxMin.z && p.z <= boxMax.z)
+        {
+            result.push_back(i);
+        }
+    });
+}
+
+void spatialHashQueryPairs(SpatialHash &hash, float distance, SpatialHashPairs &pairs, ThreadPool *pool)
+{
+    /* room for about one pair per object up front, so the buffers don't grow with every new maximum of contacts */
+    pairs.clear();
+    unsigned int count = static_cast<unsigned int>(hash.positions.size());
+    pairs.reserve(count);
+    if(!pool)
+    {
+        detail::collectPairs(hash, distance, 0, count, pairs);
+        return;
+    }
+
+    /* one output per chunk, appended in chunk order so the result doesn't depend on the scheduling */
+    hash.chunkPairs.resize(threadPoolSize(*pool));
+    for (auto &chunk : hash.chunkPairs) {
+        chunk.clear();
+        chunk.reserve(count / hash.chunkPairs.size() + 1);
+    }
+    threadPoolParallelFor(*pool, count, [&hash, distance](unsigned int begin, unsigned int end, unsigned int chunk) {
+        detail::collectPairs(hash, distance, begin, end, hash.chunkPairs[chunk]);
+    });
+    for (const auto &chunk : hash.chunkPairs) {
+        pairs.insert(pairs.end(), chunk.begin(), chunk.end());
+    }
+}
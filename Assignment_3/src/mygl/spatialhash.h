@@ -0,0 +1,78 @@
+#pragma once
+
+#include "base.h"
+#include "threadpool.h"
+
+#include <utility>
+#include <vector>
+
+/* all pairs (i < j) closer than a distance, pairs of chunk k before those of chunk k + 1, i.e. sorted by i */
+using SpatialHashPairs = std::vector<std::pair<unsigned int, unsigned int>>;
+
+/* Uniform grid over the ground plane (x, z) for proximity queries between many moving objects. Grid cells are
+ * hashed into a table with a power of two size (about two slots per object), so the grid is unbounded and memory
+ * only depends on the number of objects. Objects of one slot are stored contiguously (counting sort by slot), a
+ * query visits the slots of the cells it overlaps and skips objects of other cells that landed in the same slot. The
+ * hash is rebuilt from all positions every step, which is O(n) and cheaper than tracking cell changes. */
+struct SpatialHash
+{
+    float cellSize = 10.0f;
+    unsigned int tableMask = 0;
+
+    std::vector<Vector3D> positions;    // positions of the last build
+    std::vector<int> cellX;             // grid cell of each object
+    std::vector<int> cellZ;
+    std::vector<unsigned int> slots;    // table slot of each object
+    std::vector<unsigned int> slotStart; // objects of slot s are entries[slotStart[s] .. slotStart[s + 1])
+    std::vector<unsigned int> entries;  // object indices sorted by slot (ascending within a slot)
+    std::vector<SpatialHashPairs> chunkPairs;   // per-worker output of spatialHashQueryPairs(...), reused every query
+};
+
+/**
+ * @brief Creates an empty spatial hash.
+ *
+ * @param cellSize Edge length of a grid cell, about the typical query radius.
+ *
+ * @return Spatial hash.
+ */
+SpatialHash spatialHashCreate(float cellSize);
+
+/**
+ * @brief Rebuilds the hash from the object positions. Cells and slots are computed on the pool, the counting sort
+ * runs on the calling thread.
+ *
+ * @param hash Spatial hash.
+ * @param positions Object positions, the index of a position is the object index in query results.
+ * @param pool Worker threads, nullptr runs on the calling thread.
+ */
+void spatialHashBuild(SpatialHash& hash, const std::vector<Vector3D>& positions, ThreadPool* pool = nullptr);
+
+/**
+ * @brief Objects within a distance of a point.
+ *
+ * @param hash Spatial hash.
+ * @param center Query point.
+ * @param radius Query distance.
+ * @param result Gets the indices of the objects (cleared first).
+ */
+void spatialHashQueryRadius(const SpatialHash& hash, const Vector3D& center, float radius, std::vector<unsigned int>& result);
+
+/**
+ * @brief Objects inside an axis aligned box.
+ *
+ * @param hash Spatial hash.
+ * @param boxMin, boxMax Corners of the box.
+ * @param result Gets the indices of the objects (cleared first).
+ */
+void spatialHashQueryBox(const SpatialHash& hash, const Vector3D& boxMin, const Vector3D& boxMax, std::vector<unsigned int>& result);
+
+/**
+ * @brief All pairs of objects closer than a distance (e.g. overlapping bounding spheres), in parallel.
+ *
+ * @param hash Spatial hash (its per-worker pair buffers are reused, so the query doesn't allocate once they are large
+ * enough).
+ * @param distance Largest distance of a pair.
+ * @param pairs Gets the pairs (cleared first).
+ * @param pool Worker threads, nullptr runs on the calling thread.
+ */
+void spatialHashQueryPairs(SpatialHash& hash, float distance, SpatialHashPairs& pairs, ThreadPool* pool = nullptr);
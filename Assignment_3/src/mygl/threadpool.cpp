@@ -0,0 +1,92 @@
+#include "threadpool.h"
+
+#include <algorithm>
+
+namespace detail
+{
+    void workerLoop(ThreadPoolState &state)
+    {
+        while (true) {
+            ThreadPoolJob job;
+            {
+                std::unique_lock<std::mutex> lock(state.mutex);
+                state.wake.wait(lock, [&state] { return state.stop || state.nextJob < state.numJobs; });
+                if (state.nextJob == state.numJobs) {
+                    return;
+                }
+                job = state.jobs[state.nextJob++];
+            }
+
+            job.fn(job.context, job.begin, job.end, job.chunk);
+
+            std::lock_guard<std::mutex> lock(state.mutex);
+            if (--state.pending == 0) {
+                state.done.notify_all();
+            }
+        }
+    }
+}
+
+ThreadPool threadPoolCreate(unsigned int numThreads)
+{
+    if (numThreads == 0) {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    ThreadPool pool;
+    pool.state = std::make_unique<ThreadPoolState>();
+    pool.state->jobs.resize(numThreads);
+    for (unsigned int i = 0; i < numThreads; i++) {
+        pool.threads.emplace_back(detail::workerLoop, std::ref(*pool.state));
+    }
+    return pool;
+}
+
+void threadPoolParallelFor(ThreadPool &pool, unsigned int count, ThreadPoolChunkFn fn, const void *context)
+{
+    unsigned int numChunks = std::min(count, threadPoolSize(pool));
+    if (numChunks == 0) {
+        return;
+    }
+
+    ThreadPoolState &state = *pool.state;
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        for (unsigned int c = 0; c < numChunks; c++) {
+            unsigned int begin = static_cast<unsigned int>(static_cast<unsigned long long>(count) * c / numChunks);
+            unsigned int end = static_cast<unsigned int>(static_cast<unsigned long long>(count) * (c + 1) / numChunks);
+            state.jobs[c] = {fn, context, begin, end, c};
+        }
+        state.nextJob = 0;
+        state.numJobs = numChunks;
+        state.pending = numChunks;
+    }
+    state.wake.notify_all();
+
+    std::unique_lock<std::mutex> lock(state.mutex);
+    state.done.wait(lock, [&state] { return state.pending == 0; });
+}
+
+unsigned int threadPoolSize(const ThreadPool &pool)
+{
+    return static_cast<unsigned int>(pool.threads.size());
+}
+
+void threadPoolDelete(ThreadPool &pool)
+{
+    if (!pool.state) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(pool.state->mutex);
+        pool.state->stop = true;
+    }
+    pool.state->wake.notify_all();
+
+    for (auto &thread : pool.threads) {
+        thread.join();
+    }
+    pool.threads.clear();
+    pool.state.reset();
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* chunk function of a parallel for: (context, begin, end, chunk index) */
+using ThreadPoolChunkFn = void (*)(const void *, unsigned int, unsigned int, unsigned int);
+
+struct ThreadPoolJob
+{
+    ThreadPoolChunkFn fn = nullptr;
+    const void *context = nullptr;
+    unsigned int begin = 0;
+    unsigned int end = 0;
+    unsigned int chunk = 0;
+};
+
+/* shared state of the workers, kept behind a pointer so the pool itself can be moved. The jobs of the running
+ * parallel for live in a fixed array with one entry per worker, so starting one doesn't allocate. */
+struct ThreadPoolState
+{
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    std::vector<ThreadPoolJob> jobs;
+    unsigned int nextJob = 0;       // jobs[nextJob .. numJobs) wait for a worker
+    unsigned int numJobs = 0;
+    unsigned int pending = 0;
+    bool stop = false;
+};
+
+struct ThreadPool
+{
+    std::vector<std::thread> threads;
+    std::unique_ptr<ThreadPoolState> state;
+};
+
+/**
+ * @brief Starts a pool of worker threads.
+ *
+ * @param numThreads Number of workers, 0 picks one per hardware thread.
+ *
+ * @return Thread pool waiting for jobs.
+ */
+ThreadPool threadPoolCreate(unsigned int numThreads = 0);
+
+/**
+ * @brief Splits the index range [0, count) into one contiguous chunk per worker and runs them in parallel. Blocks until
+ * all chunks are finished. Only one parallel for runs at a time (call it from one thread, not from inside a chunk).
+ *
+ * @param pool Thread pool that runs the chunks.
+ * @param count Number of elements.
+ * @param fn Function called once per non-empty chunk with (context, begin, end, chunk index). The chunk index is smaller
+ * than threadPoolSize(pool) and can be used to address per-worker output.
+ * @param context Passed to fn.
+ */
+void threadPoolParallelFor(ThreadPool& pool, unsigned int count, ThreadPoolChunkFn fn, const void *context);
+
+/**
+ * @brief Same as above for any callable (e.g. a lambda) taking (begin, end, chunk index), which is passed by
+ * reference, so nothing is copied or allocated.
+ */
+template <typename Fn>
+void threadPoolParallelFor(ThreadPool& pool, unsigned int count, const Fn& fn)
+{
+    threadPoolParallelFor(pool, count, [](const void *context, unsigned int begin, unsigned int end, unsigned int chunk) {
+        (*static_cast<const Fn *>(context))(begin, end, chunk);
+    }, &fn);
+}
+
+/**
+ * @brief Number of worker threads of a pool.
+ */
+unsigned int threadPoolSize(const ThreadPool& pool);
+
+/**
+ * @brief Finishes all queued jobs and joins the worker threads.
+ *
+ * @param pool Thread pool to delete.
+ */
+void threadPoolDelete(ThreadPool& pool);
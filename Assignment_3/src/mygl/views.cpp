@@ -0,0 +1,106 @@
+#include "views.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace detail
+{
+    /* std140 layout of the `View` block: mat4 uView, mat4 uProj */
+    constexpr GLint viewBlockSize = 2 * 16 * sizeof(float);
+}
+
+ViewSet viewSetCreate()
+{
+    ViewSet set;
+    GLint alignment = 256;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    alignment = std::max(alignment, 1);
+    set.stride = (detail::viewBlockSize + alignment - 1) / alignment * alignment;
+
+    glGenBuffers(1, &set.ubo);
+    return set;
+}
+
+void viewSetClear(ViewSet &set)
+{
+    set.views.clear();
+}
+
+unsigned int viewSetAdd(ViewSet &set, const Matrix4D &view, const Matrix4D &projection, float x, float y, float width, float height)
+{
+    if(set.views.size() >= MAX_VIEWS)
+    {
+        return MAX_VIEWS;
+    }
+
+    View v;
+    v.view = view;
+    v.projection = projection;
+    v.frustum = frustumCreate(projection * view);
+    v.viewport[0] = x;
+    v.viewport[1] = y;
+    v.viewport[2] = width;
+    v.viewport[3] = height;
+    set.views.push_back(v);
+    return static_cast<unsigned int>(set.views.size() - 1);
+}
+
+void viewSetFrustums(const ViewSet &set, std::vector<Frustum> &frustums)
+{
+    frustums.resize(set.views.size());
+    for (std::size_t i = 0; i < set.views.size(); i++) {
+        frustums[i] = set.views[i].frustum;
+    }
+}
+
+void viewSetUpload(ViewSet &set)
+{
+    GLsizeiptr size = static_cast<GLsizeiptr>(set.views.size()) * set.stride;
+    if(size == 0)
+    {
+        return;
+    }
+
+    set.staging.resize(static_cast<std::size_t>(size));
+    for (std::size_t i = 0; i < set.views.size(); i++) {
+        unsigned char *block = set.staging.data() + i * set.stride;
+        std::memcpy(block, set.views[i].view.ptr(), 16 * sizeof(float));
+        std::memcpy(block + 16 * sizeof(float), set.views[i].projection.ptr(), 16 * sizeof(float));
+    }
+
+    /* orphan the storage of the last frame, the GPU may still read it */
+    glBindBuffer(GL_UNIFORM_BUFFER, set.ubo);
+    set.capacity = std::max(set.capacity, size);
+    glBufferData(GL_UNIFORM_BUFFER, set.capacity, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, size, set.staging.data());
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void viewSetBind(const ViewSet &set, unsigned int index, const GLint target[4])
+{
+    const View &view = set.views[index];
+    glBindBufferRange(GL_UNIFORM_BUFFER, VIEW_UNIFORM_BINDING, set.ubo, static_cast<GLintptr>(index) * set.stride, detail::viewBlockSize);
+
+    GLint x = target[0] + static_cast<GLint>(std::lround(view.viewport[0] * target[2]));
+    GLint y = target[1] + static_cast<GLint>(std::lround(view.viewport[1] * target[3]));
+    GLsizei width = static_cast<GLsizei>(std::lround(view.viewport[2] * target[2]));
+    GLsizei height = static_cast<GLsizei>(std::lround(view.viewport[3] * target[3]));
+    glViewport(x, y, width, height);
+    glScissor(x, y, width, height);
+}
+
+void viewSetBindShader(const ShaderProgram &shader)
+{
+    GLuint block = glGetUniformBlockIndex(shader.id, "View");
+    if(block != GL_INVALID_INDEX)
+    {
+        glUniformBlockBinding(shader.id, block, VIEW_UNIFORM_BINDING);
+    }
+}
+
+void viewSetDelete(ViewSet &set)
+{
+    glDeleteBuffers(1, &set.ubo);
+    set = ViewSet();
+}
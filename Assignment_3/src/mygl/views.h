@@ -0,0 +1,98 @@
+#pragma once
+
+#include "base.h"
+#include "culling.h"
+#include "shader.h"
+
+#include <vector>
+
+/* binding point of the `View` uniform block (view and projection matrix) of the shaders */
+constexpr GLuint VIEW_UNIFORM_BINDING = 0;
+
+/* at most as many views as there are bits in DrawItem::viewMask */
+constexpr unsigned int MAX_VIEWS = 32;
+
+/* one camera of the frame rendered into a part of the render target */
+struct View
+{
+    Matrix4D view;
+    Matrix4D projection;
+    Frustum frustum;
+    float viewport[4];      // x, y, width, height as fractions of the render target (origin bottom left)
+};
+
+/* All views of a frame. The matrices of every view go into one uniform buffer with a single upload per frame, a view
+ * is selected by binding its range of the buffer. Draw lists are built once for all views: culling gives every item
+ * a bit mask of the views that see it and each view replays the commands with its bit set. */
+struct ViewSet
+{
+    std::vector<View> views;
+    GLuint ubo = 0;
+    GLsizeiptr capacity = 0;        // bytes of the uniform buffer
+    GLint stride = 0;               // bytes per view, rounded up to the uniform buffer offset alignment
+    std::vector<unsigned char> staging;
+};
+
+/**
+ * @brief Creates an empty view set and its uniform buffer.
+ *
+ * @return View set.
+ */
+ViewSet viewSetCreate();
+
+/**
+ * @brief Removes all views of the last frame.
+ *
+ * @param set View set.
+ */
+void viewSetClear(ViewSet& set);
+
+/**
+ * @brief Adds a view, its frustum is extracted from projection * view.
+ *
+ * @param set View set.
+ * @param view View matrix.
+ * @param projection Projection matrix (perspective or ortho).
+ * @param x, y, width, height Viewport as fractions of the render target.
+ *
+ * @return Index of the view (bit of DrawItem::viewMask), MAX_VIEWS if the set is full.
+ */
+unsigned int viewSetAdd(ViewSet& set, const Matrix4D& view, const Matrix4D& projection, float x, float y, float width, float height);
+
+/**
+ * @brief Frustums of all views, in view order (e.g. for cullDrawItems(...)).
+ *
+ * @param set View set.
+ * @param frustums Gets one frustum per view.
+ */
+void viewSetFrustums(const ViewSet& set, std::vector<Frustum>& frustums);
+
+/**
+ * @brief Writes the matrices of all views into the uniform buffer with one upload.
+ *
+ * @param set View set.
+ */
+void viewSetUpload(ViewSet& set);
+
+/**
+ * @brief Makes a view current: binds its part of the uniform buffer and sets its viewport and scissor rectangle.
+ *
+ * @param set View set (uploaded).
+ * @param index View index.
+ * @param target Viewport of the whole render target (x, y, width, height in pixels).
+ */
+void viewSetBind(const ViewSet& set, unsigned int index, const GLint target[4]);
+
+/**
+ * @brief Connects the `View` uniform block of a shader to VIEW_UNIFORM_BINDING (needed once per linked program).
+ *
+ * @param shader Shader program.
+ */
+void viewSetBindShader(const ShaderProgram& shader);
+
+/**
+ * @brief Deletes the uniform buffer.
+ *
+ * @param set View set to delete.
+ */
+void viewSetDelete(ViewSet& set);
@@ -1,17 +1,65 @@
 #include <cstdlib>
 #include <iostream>
 #include <cmath> // für fabs
+#include <algorithm>
 
+#include "mygl/culling.h"
 #include "mygl/mesh.h"
+#include "mygl/profiler.h"
 #include "mygl/shader.h"
 #include "ground.h"
 #include "pickup.h"
 
+namespace detail
+{
+    /* Szenengraph: Fahrzeug -> Teile, Radaufhängung -> Rad. Jedes Fahrzeug belegt genau einen Wurzelknoten
+     * und einen zusammenhängenden Bereich an Knoten. */
+    void addSceneGraphNodes(Pickup &pickup, SceneGraph &sceneGraph) {
+        pickup.nodeVehicle = sceneGraphAddNode(sceneGraph, -1, pickup.vehicleTransform);
+
+        // Base
+        pickup.nodeBase = sceneGraphAddNode(sceneGraph, pickup.nodeVehicle,
+            Matrix4D::translation({0.0f, pickup.baseY, 0.0f}) *
+            Matrix4D::scale(pickup.baseLength, pickup.baseHeight, pickup.baseWidth));
+
+        // Cockpit
+        float cockpitX = pickup.baseLength / 4.0f;
+        float cockpitY = pickup.baseY + pickup.baseHeight + 1.0f;
+        pickup.nodeCockpit = sceneGraphAddNode(sceneGraph, pickup.nodeVehicle,
+            Matrix4D::translation({cockpitX, cockpitY, 0.0f}) *
+            Matrix4D::scale(1.0f, 1.0f, pickup.baseWidth));
+
+        // Räder: Aufhängung (Position + Lenkung) und darunter das Rad selbst (Ausrichtung + Rollen + Größe)
+        for (int i = 0; i < 4; i++) {
+            pickup.nodeWheelPivot[i] = sceneGraphAddNode(sceneGraph, pickup.nodeVehicle, Matrix4D::translation(pickup.wheelPos[i]));
+            pickup.nodeWheel[i] = sceneGraphAddNode(sceneGraph, pickup.nodeWheelPivot[i], Matrix4D::identity());
+        }
+
+        // Ersatzrad – horizontal auf der Ladefläche am Heck, nur um X rotieren für querstehenden Reifen
+        float spareX = -pickup.baseLength * 1.0f - pickup.wheelThickness;
+        float spareY = pickup.frontWheelRadius + 2.0f;
+        float spareZ = 0.0f;
+        pickup.nodeSpare = sceneGraphAddNode(sceneGraph, pickup.nodeVehicle,
+            Matrix4D::translation({spareX, spareY, spareZ}) *
+            Matrix4D::rotationX(to_radians(90.0f)) *
+            Matrix4D::scale(pickup.wheelThickness, pickup.frontWheelRadius, pickup.frontWheelRadius));
+    }
+}
+
 /* -------------------------------------------------------
- * Pickup erstellen: Geometrie + lokale Modelmatrizen
+ * Pickup erstellen: Geometrie + Knoten im Szenengraph
  * ----------------------------------------------------- */
 
-Pickup pickupCreate(const Vector4D &colorBase, const Vector4D &colorCockpit, const Vector4D &colorWheels) {
+Pickup pickupCreate(MeshBuffer &meshBuffer, SceneGraph &sceneGraph, const Vector4D &colorBase, const Vector4D &colorCockpit, const Vector4D &colorWheels) {
+    // Meshes (alle im gemeinsamen Mesh-Buffer -> ein VAO für das ganze Fahrzeug)
+    Mesh base    = meshBufferAdd(meshBuffer, cube::vertexPos,     cube::indices,     colorBase);
+    Mesh cockpit = meshBufferAdd(meshBuffer, cube::vertexPos,     cube::indices,     colorCockpit);
+    Mesh wheel   = meshBufferAdd(meshBuffer, cylinder::vertexPos, cylinder::indices, colorWheels);
+
+    return pickupCreate(sceneGraph, base, cockpit, wheel);
+}
+
+Pickup pickupCreate(SceneGraph &sceneGraph, const Mesh &base, const Mesh &cockpit, const Mesh &wheel) {
     Pickup pickup;
 
     // Basis-Maße
@@ -37,167 +85,144 @@ Pickup pickupCreate(const Vector4D &colorBase, const Vector4D &colorCockpit, con
     pickup.wheelRotationAngle = 0.0f;
     pickup.wheelSteeringAngle = 0.0f;
 
-    // Meshes
-    pickup.base     = meshCreate(cube::vertexPos,     cube::indices,     colorBase,    GL_STATIC_DRAW, GL_STATIC_DRAW);
-    pickup.cockpit  = meshCreate(cube::vertexPos,     cube::indices,     colorCockpit, GL_STATIC_DRAW, GL_STATIC_DRAW);
-    pickup.wheelFL  = meshCreate(cylinder::vertexPos, cylinder::indices, colorWheels,  GL_STATIC_DRAW, GL_STATIC_DRAW);
-    pickup.wheelFR  = meshCreate(cylinder::vertexPos, cylinder::indices, colorWheels,  GL_STATIC_DRAW, GL_STATIC_DRAW);
-    pickup.wheelRL  = meshCreate(cylinder::vertexPos, cylinder::indices, colorWheels,  GL_STATIC_DRAW, GL_STATIC_DRAW);
-    pickup.wheelRR  = meshCreate(cylinder::vertexPos, cylinder::indices, colorWheels,  GL_STATIC_DRAW, GL_STATIC_DRAW);
-    pickup.spare    = meshCreate(cylinder::vertexPos, cylinder::indices, colorWheels,  GL_STATIC_DRAW, GL_STATIC_DRAW);
-
-    // ---------- lokale Modelmatrizen (im Pickup-eigenen Koordinatensystem) ----------
-
-    // Base
-    pickup.modelBaseLocal =
-        Matrix4D::translation({0.0f, pickup.baseY, 0.0f}) *
-        Matrix4D::scale(pickup.baseLength, pickup.baseHeight, pickup.baseWidth);
-
-    // Cockpit
-    float cockpitX = pickup.baseLength / 4.0f;
-    float cockpitY = pickup.baseY + pickup.baseHeight + 1.0f;
-    pickup.modelCockpitLocal =
-        Matrix4D::translation({cockpitX, cockpitY, 0.0f}) *
-        Matrix4D::scale(1.0f, 1.0f, pickup.baseWidth);
-
-    // Räder - Basispositionen ohne Rotation
-    float wheelBaseHalf = pickup.wheelBaseHalf;
-    float wheelTrack    = pickup.wheelTrack;
-
-    // Positionen korrigiert - näher am Auto und auf richtiger Höhe
-    float frontWheelX = wheelBaseHalf * 1.3f;
-    float rearWheelX  = -wheelBaseHalf * 0.8f;
-
-    float frontR    = pickup.frontWheelRadius;
-    float rearR     = pickup.rearWheelRadius;
-    float thickness = pickup.wheelThickness;
-
-    // Einfache und klare Rad-Transformation:
-    // Zylinder wird um Y-Achse gedreht, um ihn flach zu legen
-    // Dann wird er entlang X gestreckt für die Dicke
-    Matrix4D wheelRot = Matrix4D::rotationY(to_radians(90.0f));
-    Matrix4D wheelFScale = Matrix4D::scale(thickness, frontR, frontR);
-    Matrix4D wheelRScale = Matrix4D::scale(thickness, rearR, rearR);
-
-    // Radhöhe korrigiert - Räder sollen auf dem Boden stehen
-    float wheelY = pickup.frontWheelRadius; // Räder stehen auf y=0 + Radius
-
-    // Vorderräder Basispositionen - weiter außen
-    pickup.modelWheelFLBase =
-        Matrix4D::translation({frontWheelX, wheelY, -wheelTrack / 2.0f}) *
-        wheelRot * wheelFScale;
-
-    pickup.modelWheelFRBase =
-        Matrix4D::translation({frontWheelX, wheelY, wheelTrack / 2.0f}) *
-        wheelRot * wheelFScale;
-
-    // Hinterräder Basispositionen - weiter außen
-    pickup.modelWheelRLBase =
-        Matrix4D::translation({rearWheelX, wheelY, -wheelTrack / 2.0f}) *
-        wheelRot * wheelRScale;
-
-    pickup.modelWheelRRBase =
-        Matrix4D::translation({rearWheelX, wheelY, wheelTrack / 2.0f}) *
-        wheelRot * wheelRScale;
-
-        // Ersatzrad – horizontal auf der Ladefläche am Heck
-float spareX = -pickup.baseLength * 1.0f - pickup.wheelThickness;
-float spareY = pickup.frontWheelRadius + 2.0f;
-float spareZ = 0.0f;
-
-// Nur um X rotieren für querstehenden Reifen
-Matrix4D spareRot = Matrix4D::rotationX(to_radians(90.0f));
-
-pickup.modelSpareLocal =
-    Matrix4D::translation({spareX, spareY, spareZ}) *
-    spareRot *
-    Matrix4D::scale(pickup.wheelThickness, pickup.frontWheelRadius, pickup.frontWheelRadius);
+    // Meshes: alle Räder (auch das Ersatzrad) teilen sich ein Mesh, sie unterscheiden sich nur in der Transformation
+    pickup.base     = base;
+    pickup.cockpit  = cockpit;
+    for (auto &w : pickup.wheels) {
+        w           = wheel;
+    }
+    pickup.spare    = wheel;
+    pickup.ownsMeshes = true;
+
+    // ---------- Radpositionen (Radmitte im Pickup-eigenen Koordinatensystem) ----------
+    // einzige Stelle, an der die Positionen definiert sind (Zeichnen + Geländeanpassung)
+    float frontWheelX = pickup.wheelBaseHalf * 1.3f;
+    float rearWheelX  = -pickup.wheelBaseHalf * 0.8f;
+    float wheelTrack  = pickup.wheelTrack;
+
+    pickup.wheelPos[WheelFL] = Vector3D(frontWheelX, pickup.frontWheelRadius, -wheelTrack / 2.0f);
+    pickup.wheelPos[WheelFR] = Vector3D(frontWheelX, pickup.frontWheelRadius,  wheelTrack / 2.0f);
+    pickup.wheelPos[WheelRL] = Vector3D(rearWheelX,  pickup.rearWheelRadius,  -wheelTrack / 2.0f);
+    pickup.wheelPos[WheelRR] = Vector3D(rearWheelX,  pickup.rearWheelRadius,   wheelTrack / 2.0f);
+
+    detail::addSceneGraphNodes(pickup, sceneGraph);
+
+    pickupUpdateSceneGraph(pickup, sceneGraph);
+
+    // Bounding Box in Fahrzeugkoordinaten (vehicleTransform ist hier noch die Identität). Aus den Bounding Spheres
+    // der Teile, damit sie auch bei Lenkung und Rollen der Räder konservativ bleibt.
+    sceneGraphUpdateRoots(sceneGraph, sceneGraph.roots.size() - 1, sceneGraph.roots.size());
+    FrameVector<DrawItem> parts;
+    pickupCollectDrawItems(pickup, sceneGraph, DRAW_NO_OBJECT, parts);
+
+    pickup.boundsMin = Vector3D(1e30f, 1e30f, 1e30f);
+    pickup.boundsMax = -pickup.boundsMin;
+    for (const auto &part : parts) {
+        BoundingSphere sphere = boundsTransform(part.mesh, part.model);
+        for (unsigned k = 0; k < 3; k++) {
+            pickup.boundsMin[k] = std::min(pickup.boundsMin[k], sphere.center[k] - sphere.radius);
+            pickup.boundsMax[k] = std::max(pickup.boundsMax[k], sphere.center[k] + sphere.radius);
+        }
+    }
 
     return pickup;
 }
 
 /* -------------------------------------------------------
- * Zeichnen: vehicleTransform * lokaleModelMatrix
+ * Weiteres Fahrzeug mit denselben Meshes (keine neuen Buffer)
  * ----------------------------------------------------- */
 
-void pickupDraw(const Pickup &pickup, ShaderProgram &shader) {
-    const Matrix4D &W = pickup.vehicleTransform;
+Pickup pickupCreateInstance(const Pickup &prototype, SceneGraph &sceneGraph, const Matrix4D &vehicleTransform) {
+    Pickup pickup = prototype;
+    pickup.ownsMeshes = false;
+    pickup.vehicleTransform = vehicleTransform;
+    pickup.wheelRotationAngle = 0.0f;
+    pickup.wheelSteeringAngle = 0.0f;
 
-    // Base
-    shaderUniform(shader, "uModel", W * pickup.modelBaseLocal);
-    glBindVertexArray(pickup.base.vao);
-    glDrawElements(GL_TRIANGLES, pickup.base.size_ibo, GL_UNSIGNED_INT, nullptr);
+    detail::addSceneGraphNodes(pickup, sceneGraph);
+    pickupUpdateSceneGraph(pickup, sceneGraph);
 
-    // Cockpit
-    shaderUniform(shader, "uModel", W * pickup.modelCockpitLocal);
-    glBindVertexArray(pickup.cockpit.vao);
-    glDrawElements(GL_TRIANGLES, pickup.cockpit.size_ibo, GL_UNSIGNED_INT, nullptr);
+    return pickup;
+}
+
+/* -------------------------------------------------------
+ * Lokale Transformationen in den Szenengraph schreiben.
+ * Unveränderte Matrizen markieren keinen Knoten als dirty,
+ * ein parkendes Fahrzeug kostet daher keine Neuberechnung.
+ * ----------------------------------------------------- */
+
+void pickupUpdateSceneGraph(const Pickup &pickup, SceneGraph &sceneGraph) {
+    pickupUpdateSceneGraph(pickup, pickupGetState(pickup), sceneGraph);
+}
+
+void pickupUpdateSceneGraph(const Pickup &pickup, const PickupState &state, SceneGraph &sceneGraph) {
+    sceneGraphSetLocal(sceneGraph, pickup.nodeVehicle, state.vehicleTransform);
 
     // --- Radrotationen ---
-    Matrix4D roll = Matrix4D::rotationX(pickup.wheelRotationAngle);
-    Matrix4D steering = Matrix4D::rotationY(pickup.wheelSteeringAngle);
+    Matrix4D roll = Matrix4D::rotationX(state.wheelRotationAngle);
+    Matrix4D steering = Matrix4D::rotationY(state.wheelSteeringAngle);
     Matrix4D wheelTilt = Matrix4D::rotationY(to_radians(90.0f)); // Zylinder-Achse anpassen
 
-    // --- Vorderräder ---
-    float wheelTrack = pickup.wheelTrack;
-    float wheelBaseHalf = pickup.wheelBaseHalf;
-    float wheelY = pickup.frontWheelRadius;
-    float frontWheelX = wheelBaseHalf * 1.3f;
-    float thickness = pickup.wheelThickness;
-    float frontR = pickup.frontWheelRadius;
-
-    // Gemeinsame Skalierung
-    Matrix4D scaleF = Matrix4D::scale(thickness, frontR, frontR);
-
-    // Linkes Vorderrad
-    {
-        Matrix4D local =
-            Matrix4D::translation({frontWheelX, wheelY, -wheelTrack / 2.0f}) *
-            steering * wheelTilt * roll * scaleF;
-        shaderUniform(shader, "uModel", W * local);
-        glBindVertexArray(pickup.wheelFL.vao);
-        glDrawElements(GL_TRIANGLES, pickup.wheelFL.size_ibo, GL_UNSIGNED_INT, nullptr);
-    }
+    for (int i = 0; i < 4; i++) {
+        bool front = (i == WheelFL || i == WheelFR);
+        float radius = front ? pickup.frontWheelRadius : pickup.rearWheelRadius;
 
-    // Rechtes Vorderrad
-    {
-        Matrix4D local =
-            Matrix4D::translation({frontWheelX, wheelY,  wheelTrack / 2.0f}) *
-            steering * wheelTilt * roll * scaleF;
-        shaderUniform(shader, "uModel", W * local);
-        glBindVertexArray(pickup.wheelFR.vao);
-        glDrawElements(GL_TRIANGLES, pickup.wheelFR.size_ibo, GL_UNSIGNED_INT, nullptr);
+        // nur die Vorderräder lenken
+        Matrix4D pivot = Matrix4D::translation(pickup.wheelPos[i]);
+        sceneGraphSetLocal(sceneGraph, pickup.nodeWheelPivot[i], front ? pivot * steering : pivot);
+        sceneGraphSetLocal(sceneGraph, pickup.nodeWheel[i], wheelTilt * roll * Matrix4D::scale(pickup.wheelThickness, radius, radius));
     }
+}
 
-    // --- Hinterräder ---
-    float rearWheelX = -wheelBaseHalf * 0.8f;
-    float rearR = pickup.rearWheelRadius;
-    Matrix4D scaleR = Matrix4D::scale(thickness, rearR, rearR);
-
-    // Links hinten
-    {
-        Matrix4D local =
-            Matrix4D::translation({rearWheelX, rearR, -wheelTrack / 2.0f}) *
-            wheelTilt * roll * scaleR;
-        shaderUniform(shader, "uModel", W * local);
-        glBindVertexArray(pickup.wheelRL.vao);
-        glDrawElements(GL_TRIANGLES, pickup.wheelRL.size_ibo, GL_UNSIGNED_INT, nullptr);
-    }
+/* -------------------------------------------------------
+ * Zustand für die Interpolation zwischen Simulationsschritten
+ * ----------------------------------------------------- */
+
+PickupState pickupGetState(const Pickup &pickup) {
+    return {pickup.vehicleTransform, pickup.wheelRotationAngle, pickup.wheelSteeringAngle};
+}
 
-    // Rechts hinten
-    {
-        Matrix4D local =
-            Matrix4D::translation({rearWheelX, rearR,  wheelTrack / 2.0f}) *
-            wheelTilt * roll * scaleR;
-        shaderUniform(shader, "uModel", W * local);
-        glBindVertexArray(pickup.wheelRR.vao);
-        glDrawElements(GL_TRIANGLES, pickup.wheelRR.size_ibo, GL_UNSIGNED_INT, nullptr);
+PickupState pickupInterpolate(const PickupState &a, const PickupState &b, float alpha) {
+    PickupState result = b;
+
+    // Spalten linear mischen; bei kleinen Schritten genau genug, danach wieder orthonormal machen (Gram-Schmidt)
+    Matrix4D &M = result.vehicleTransform;
+    for (int j = 0; j < 4; j++) {
+        M[j] = a.vehicleTransform[j] * (1.0f - alpha) + b.vehicleTransform[j] * alpha;
+    }
+    Vector3D x = normalize(Vector3D(M[0].x, M[0].y, M[0].z));
+    Vector3D y = Vector3D(M[1].x, M[1].y, M[1].z);
+    y = normalize(y - x * dot(x, y));
+    Vector3D z = cross(x, y);
+    M[0] = Vector4D(x, 0.0f);
+    M[1] = Vector4D(y, 0.0f);
+    M[2] = Vector4D(z, 0.0f);
+
+    // Radwinkel wird bei ±2π umgebrochen, über den kürzeren Weg mischen
+    float roll = b.wheelRotationAngle - a.wheelRotationAngle;
+    if (roll > M_PI) {
+        roll -= 2.0f * M_PI;
+    } else if (roll < -M_PI) {
+        roll += 2.0f * M_PI;
     }
+    result.wheelRotationAngle = a.wheelRotationAngle + alpha * roll;
+    result.wheelSteeringAngle = a.wheelSteeringAngle + alpha * (b.wheelSteeringAngle - a.wheelSteeringAngle);
 
-    // --- Ersatzrad ---
-    shaderUniform(shader, "uModel", W * pickup.modelSpareLocal);
-    glBindVertexArray(pickup.spare.vao);
-    glDrawElements(GL_TRIANGLES, pickup.spare.size_ibo, GL_UNSIGNED_INT, nullptr);
+    return result;
+}
+
+/* -------------------------------------------------------
+ * Zeichnen: Weltmatrizen kommen aus dem Szenengraph
+ * (nur Draw-Items sammeln, Culling + GL-Aufrufe macht die Szene)
+ * ----------------------------------------------------- */
+
+void pickupCollectDrawItems(const Pickup &pickup, const SceneGraph &sceneGraph, unsigned int object, FrameVector<DrawItem> &items) {
+    items.push_back({pickup.base, sceneGraph.world[pickup.nodeBase], object});
+    items.push_back({pickup.cockpit, sceneGraph.world[pickup.nodeCockpit], object});
+    for (int i = 0; i < 4; i++) {
+        items.push_back({pickup.wheels[i], sceneGraph.world[pickup.nodeWheel[i]], object});
+    }
+    items.push_back({pickup.spare, sceneGraph.world[pickup.nodeSpare], object});
 }
 
 
@@ -205,14 +230,14 @@ void pickupDraw(const Pickup &pickup, ShaderProgram &shader) {
  * Ressourcen freigeben
  * ----------------------------------------------------- */
 
-void pickupDelete(Pickup &pickup) {
-    meshDelete(pickup.base);
-    meshDelete(pickup.cockpit);
-    meshDelete(pickup.wheelFL);
-    meshDelete(pickup.wheelFR);
-    meshDelete(pickup.wheelRL);
-    meshDelete(pickup.wheelRR);
-    meshDelete(pickup.spare);
+void pickupDelete(MeshBuffer &meshBuffer, Pickup &pickup) {
+    if (!pickup.ownsMeshes) {
+        return;
+    }
+    meshDelete(meshBuffer, pickup.base);
+    meshDelete(meshBuffer, pickup.cockpit);
+    // alle Räder und das Ersatzrad teilen sich ein Mesh, es wird nur einmal freigegeben
+    meshDelete(meshBuffer, pickup.wheels[0]);
 }
 
 /* -------------------------------------------------------
@@ -314,16 +339,15 @@ Vector3D pickupGetWorldPosition(const Pickup &pickup) {
 }
 
 void pickupAdjustToTerrain(Pickup &pickup, const Ground &ground) {
-    // Lokale Aufstandspunkte der Räder (im Pickup-Koordinatensystem)
-    float frontWheelX = pickup.wheelBaseHalf * 1.3f;
-    float rearWheelX  = -pickup.wheelBaseHalf * 0.8f;
-    float wheelY = pickup.frontWheelRadius;
-    float wheelTrack = pickup.wheelTrack;
+    PROFILE_CPU("pickupAdjustToTerrain");
 
-    Vector3D localWheelFL = Vector3D(frontWheelX, wheelY, -wheelTrack/2.0f);
-    Vector3D localWheelFR = Vector3D(frontWheelX, wheelY,  wheelTrack/2.0f);
-    Vector3D localWheelRL = Vector3D(rearWheelX,  wheelY, -wheelTrack/2.0f);
-    Vector3D localWheelRR = Vector3D(rearWheelX,  wheelY,  wheelTrack/2.0f);
+    // Lokale Aufstandspunkte der Räder (im Pickup-Koordinatensystem). Die Anpassung rechnet wie bisher für alle vier
+    // Räder mit der Höhe des Vorderradradius, auch wenn die Hinterräder größer gezeichnet werden
+    float wheelY = pickup.frontWheelRadius;
+    Vector3D localWheelFL(pickup.wheelPos[WheelFL].x, wheelY, pickup.wheelPos[WheelFL].z);
+    Vector3D localWheelFR(pickup.wheelPos[WheelFR].x, wheelY, pickup.wheelPos[WheelFR].z);
+    Vector3D localWheelRL(pickup.wheelPos[WheelRL].x, wheelY, pickup.wheelPos[WheelRL].z);
+    Vector3D localWheelRR(pickup.wheelPos[WheelRR].x, wheelY, pickup.wheelPos[WheelRR].z);
 
     // Transformiere lokale Positionen in Weltkoordinaten
     Matrix4D &M = pickup.vehicleTransform;
@@ -1,20 +1,35 @@
 #pragma once
 
+#include "mygl/culling.h"
 #include "mygl/mesh.h"
+#include "mygl/meshbuffer.h"
+#include "mygl/scenegraph.h"
 #include "mygl/geometry.h"
 
+enum eWheel { WheelFL = 0, WheelFR = 1, WheelRL = 2, WheelRR = 3 };
+
 struct Pickup {
     // Meshes
     Mesh base;
     Mesh cockpit;
-    Mesh wheelFL, wheelFR, wheelRL, wheelRR;
+    Mesh wheels[4];     // Index: eWheel
     Mesh spare;
+    bool ownsMeshes;    // false bei Instanzen, die die Meshes eines anderen Pickups mitbenutzen
+
+    // Knoten im Szenengraph (lokale Matrizen relativ zum Elternknoten, Weltmatrizen dort gecacht)
+    int nodeVehicle;
+    int nodeBase;
+    int nodeCockpit;
+    int nodeWheelPivot[4];  // Radposition + Lenkung
+    int nodeWheel[4];       // Ausrichtung + Rollen + Größe
+    int nodeSpare;
+
+    // Radmitten im Pickup-Koordinatensystem (Index: eWheel)
+    Vector3D wheelPos[4];
 
-    // Lokale Modellmatrizen (relativ zum Pickup-Ursprung)
-    Matrix4D modelBaseLocal;
-    Matrix4D modelCockpitLocal;
-    Matrix4D modelWheelFLBase, modelWheelFRBase, modelWheelRLBase, modelWheelRRBase;
-    Matrix4D modelSpareLocal;
+    // Bounding Box des ganzen Fahrzeugs im Pickup-Koordinatensystem (z.B. für Occlusion Queries)
+    Vector3D boundsMin;
+    Vector3D boundsMax;
 
     // Globale Transformationsmatrix des Fahrzeugs (Weltmatrix)
     Matrix4D vehicleTransform;
@@ -40,14 +55,43 @@ struct Pickup {
     float wheelSteeringAngle;    // Lenkwinkel der Vorderräder (nur Vorderräder)
 };
 
-/* Create a pickup truck with specified colors */
-Pickup pickupCreate(const Vector4D &colorBase, const Vector4D &colorCockpit, const Vector4D &colorWheels);
+/* State that changes every simulation step, rendering interpolates between two of them */
+struct PickupState {
+    Matrix4D vehicleTransform;
+    float wheelRotationAngle;
+    float wheelSteeringAngle;
+};
+
+/* Create a pickup truck with specified colors, its meshes are allocated from the shared mesh buffer and its parts are
+ * added as transform nodes to the scene graph */
+Pickup pickupCreate(MeshBuffer &meshBuffer, SceneGraph &sceneGraph, const Vector4D &colorBase, const Vector4D &colorCockpit, const Vector4D &colorWheels);
+
+/* Same as above with meshes that are already uploaded (e.g. from a baked mesh pack), all wheels share one mesh. The
+ * pickup takes over the meshes and frees them in pickupDelete(...) */
+Pickup pickupCreate(SceneGraph &sceneGraph, const Mesh &base, const Mesh &cockpit, const Mesh &wheel);
+
+/* Create another pickup that shares the meshes of the prototype (no new GL buffers) with its own scene graph nodes */
+Pickup pickupCreateInstance(const Pickup &prototype, SceneGraph &sceneGraph, const Matrix4D &vehicleTransform);
+
+/* Delete pickup and free its meshes in the mesh buffer (instances leave the meshes to their prototype) */
+void pickupDelete(MeshBuffer &meshBuffer, Pickup &pickup);
+
+/* Write the current vehicle transform and wheel angles into the scene graph (only changed nodes become dirty) */
+void pickupUpdateSceneGraph(const Pickup &pickup, SceneGraph &sceneGraph);
+
+/* Same as above, but with the transform and wheel angles taken from the given state (e.g. an interpolated one) */
+void pickupUpdateSceneGraph(const Pickup &pickup, const PickupState &state, SceneGraph &sceneGraph);
+
+/* Current simulation state of the pickup */
+PickupState pickupGetState(const Pickup &pickup);
 
-/* Delete pickup and free resources */
-void pickupDelete(Pickup &pickup);
+/* Blend two states (alpha = 0 gives a, 1 gives b): translation and angles linearly, the rotation re-orthonormalized */
+PickupState pickupInterpolate(const PickupState &a, const PickupState &b, float alpha);
 
-/* Draw the entire pickup truck */
-void pickupDraw(const Pickup &pickup, ShaderProgram &shader);
+/* Append all parts of the pickup truck (mesh + cached world matrix) to the draw items of the frame, tagged with the
+ * object index of the pickup (PICKUP_DRAW_ITEMS items) */
+constexpr unsigned int PICKUP_DRAW_ITEMS = 7;
+void pickupCollectDrawItems(const Pickup &pickup, const SceneGraph &sceneGraph, unsigned int object, FrameVector<DrawItem> &items);
 
 /* Update pickup transform based on input (Task 2) */
 void pickupUpdate(
@@ -4,8 +4,12 @@ layout(location = 0) in vec3 aPosition;
 layout(location = 1) in vec4 aColor;
 
 uniform mat4 uModel;
-uniform mat4 uView;
-uniform mat4 uProj;
+
+/* per-view constants, one range of a uniform buffer per view (see ViewSet) */
+layout(std140) uniform View {
+	mat4 uView;
+	mat4 uProj;
+};
 
 out vec4 tColor;
 out vec3 tFragPos;
@@ -0,0 +1,56 @@
+/* Offline mesh baker: writes the built-in geometry into a binary mesh pack (see mygl/meshpack.h) that the
+ * application maps at startup instead of building the meshes at static-init time.
+ *
+ * usage: mesh_baker [OUTPUT]   (default: meshes.pack) */
+
+#include <cstdlib>
+#include <iostream>
+
+#include "mygl/geometry.h"
+#include "mygl/meshpack.h"
+
+template <std::size_t NumPositions, std::size_t NumIndices>
+MeshPackSource bakeMesh(const std::string &name, const std::array<Vector3D, NumPositions> &positions, const std::array<unsigned int, NumIndices> &indices, const Vector4D &color) {
+    MeshPackSource mesh;
+    mesh.name = name;
+    mesh.indices.assign(indices.begin(), indices.end());
+    mesh.vertices.resize(positions.size());
+    for (unsigned i = 0; i < positions.size(); i++) {
+        mesh.vertices[i] = {positions[i], color};
+    }
+    return mesh;
+}
+
+int main(int argc, char **argv) {
+    std::string path = argc > 1 ? argv[1] : "meshes.pack";
+
+    /* colors of the pickup match the defaults of the application (Task 2) */
+    Vector4D white        = {1.0f, 1.0f, 1.0f, 1.0f};
+    Vector4D colorBase    = {0.1f, 0.1f, 0.5f, 1.0f};
+    Vector4D colorCockpit = {0.1f, 0.1f, 0.8f, 1.0f};
+    Vector4D colorWheels  = {0.15f, 0.15f, 0.15f, 1.0f};
+
+    std::vector<MeshPackSource> meshes;
+    meshes.push_back(bakeMesh("cube", cube::vertexPos, cube::indices, white));
+    meshes.push_back(bakeMesh("cylinder", cylinder::vertexPos, cylinder::indices, white));
+    meshes.push_back(bakeMesh("quad", quad::vertexPos, quad::indices, white));
+    meshes.push_back(bakeMesh("grid", grid::vertexPos, grid::indices, white));
+
+    /* composite vehicle: one mesh per part, the parts are placed by the scene graph at runtime */
+    meshes.push_back(bakeMesh("pickup.base", cube::vertexPos, cube::indices, colorBase));
+    meshes.push_back(bakeMesh("pickup.cockpit", cube::vertexPos, cube::indices, colorCockpit));
+    meshes.push_back(bakeMesh("pickup.wheel", cylinder::vertexPos, cylinder::indices, colorWheels));
+
+    if (!meshPackWrite(path, meshes)) {
+        return EXIT_FAILURE;
+    }
+
+    std::size_t numVertices = 0, numIndices = 0;
+    for (const auto &mesh : meshes) {
+        numVertices += mesh.vertices.size();
+        numIndices += mesh.indices.size();
+    }
+    std::cout << "[MeshBaker] Wrote " << meshes.size() << " meshes (" << numVertices << " vertices, " << numIndices
+              << " indices) to " << path << std::endl;
+    return EXIT_SUCCESS;
+}